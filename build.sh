@@ -10,19 +10,24 @@ if ! command -v g++ &> /dev/null; then
 fi
 
 # Kompilacja
-g++ -std=c++20 -O2 -I include -o chess_cli \
+g++ -std=c++20 -O2 -pthread -DCHESS_TT_PREFETCH -I include -o chess_cli \
     src/app/main.cpp \
     src/board/Board.cpp \
+    src/board/Position.cpp \
     src/rules/Attack.cpp \
+    src/rules/Magic.cpp \
     src/rules/Castling.cpp \
     src/rules/MoveValid.cpp \
     src/rules/MoveExec.cpp \
     src/model/Move.cpp \
+    src/model/PackedMove.cpp \
     src/rules/MoveGenerator.cpp \
     src/game/GameState.cpp \
     src/ai/Evaluator.cpp \
     src/ai/TranspositionTable.cpp \
     src/ai/ZobristHash.cpp \
+    src/ai/MovePicker.cpp \
+    src/ai/See.cpp \
     src/ai/ChessAI.cpp
 
 if [ $? -eq 0 ]; then
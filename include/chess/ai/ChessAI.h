@@ -1,9 +1,16 @@
 #pragma once
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <chrono>
 #include "chess/model/Move.h"
+#include "chess/model/MoveList.h"
+#include "chess/model/PackedMove.h"
 #include "chess/ai/TranspositionTable.h"
+#include "chess/ai/PawnHashTable.h"
+#include "chess/ai/EvalCache.h"
 #include "chess/ai/ZobristHash.h"
+#include "chess/board/Position.h"
 
 struct SearchResult {
     Move bestMove;
@@ -17,46 +24,113 @@ struct SearchResult {
 
 class ChessAI {
 private:
-    TranspositionTable transpositionTable;
+    // Lazy SMP: przy threads > 1 pomocnicze instancje szukają tej samej pozycji na własnych
+    // wątkach i własnych kopiach pozycji; łączy je tylko wspólna TT (bez blokad) i flaga stopu
+    std::shared_ptr<TranspositionTable> transpositionTable;
     uint64_t nodesVisited;
+    uint64_t ttProbes{0};
+    uint64_t ttHits{0};
+    // Tablica hash pionów - własna dla każdego wątku (mała, bez synchronizacji)
+    PawnHashTable pawnTable;
+    uint64_t pawnProbes{0};
+    uint64_t pawnHits{0};
+    // Cache oceny statycznej - wspólny dla wątków jak TT (wpisy atomowe, bez blokad)
+    std::shared_ptr<EvalCache> evalCache;
+    uint64_t evalProbes{0};
+    uint64_t evalHits{0};
     std::chrono::steady_clock::time_point searchStartTime;
     
+    int threadCount{1};
+    bool mainThread{true};              // tylko główny wątek wypisuje postęp
+    bool verbose{true};
+    std::atomic<bool> stopSearch{false};
+    const std::atomic<bool>* stop;      // flaga głównej instancji (dla pomocników - cudza)
+    
+    // Pomocnik Lazy SMP: współdzieli TT, cache oceny i flagę stopu z instancją główną
+    ChessAI(std::shared_ptr<TranspositionTable> table, std::shared_ptr<EvalCache> cache,
+            const std::atomic<bool>* stop);
+    
     // Parametry wyszukiwania
     static constexpr int MAX_DEPTH = 50;
     static constexpr int MAX_TIME_MS = 30000; // 30 sekund
+    static constexpr int INF = 32001;         // granice okna; oceny mieszczą się w 16 bitach wpisu TT
+    static constexpr int MATE_SCORE = 32000;  // mat za n półruchów = MATE_SCORE - n
+    static constexpr int MATE_BOUND = MATE_SCORE - Position::MAX_PLY;   // powyżej - ocena matowa
+    
+    // Głębokość bieżącej iteracji - ogranicza przedłużenia za szach do 2 * rootDepth półruchów
+    int rootDepth{0};
+    
+    // Killery: dwa ciche ruchy z odcięciem na każdym poziomie (indeks = pos.ply())
+    PackedMove killers[Position::MAX_PLY][2];
+    
+    // NegaMax z Alfa-Beta Pruning (ruchy wykonywane i cofane w miejscu na pos)
+    int negamax(Position& pos, int depth, int alpha, int beta);
     
-    // NegaMax z Alfa-Beta Pruning
-    int negamax(const char board[8][8], char activeColor, const std::string& castling, 
-                const std::string& enPassant, int depth, int alpha, int beta, 
-                uint64_t zobristHash);
+    // Quiescence - po osiągnięciu głębokości przeszukuj dalej tylko bicia (bez przegrywających
+    // wg SEE), żeby nie oceniać pozycji w środku wymiany
+    int quiescence(Position& pos, int alpha, int beta);
+    
+    // Ocena statyczna z perspektywy strony na ruchu, przez cache oceny
+    int evaluate(const Position& pos);
     
     // Iterative Deepening
-    SearchResult iterativeDeepening(const char board[8][8], char activeColor, 
-                                   const std::string& castling, const std::string& enPassant,
-                                   int maxDepth, int maxTimeMs);
+    SearchResult iterativeDeepening(Position& pos, int maxDepth, int maxTimeMs);
+    
+    // Oceny matowe w TT liczone od węzła, nie od korzenia (ta sama pozycja na innym ply)
+    static int scoreToTT(int score, int ply);
+    static int scoreFromTT(int score, int ply);
     
     // Sprawdzenie czy czas się skończył
     bool isTimeUp() const;
     
+    // Przerwanie wyszukiwania (koniec czasu / stop od głównego wątku). Po ustawieniu flagi
+    // wyniki węzłów są bez znaczenia: wracamy w górę bez porównywania ocen i bez zapisów do TT
+    bool aborted{false};
+    bool checkAbort() {
+        if (!aborted && isTimeUp()) aborted = true;
+        return aborted;
+    }
+    
     // Sortowanie ruchów dla lepszego Alfa-Beta Pruning
-    void sortMoves(std::vector<Move>& moves, const char board[8][8], 
-                   char activeColor, const std::string& castling, 
-                   const std::string& enPassant);
+    void sortMoves(MoveList& moves, const Position& pos);
     
 public:
     ChessAI();
     
-    // Główna funkcja AI - zwraca najlepszy ruch
-    SearchResult findBestMove(const char board[8][8], char activeColor, 
-                             const std::string& castling, const std::string& enPassant,
+    // Główna funkcja AI - zwraca najlepszy ruch. Instancja może żyć przez całą partię:
+    // TT przechodzi między wywołaniami (nowe pokolenie wpisów przy każdym wyszukiwaniu)
+    SearchResult findBestMove(const char board[8][8], char activeColor, const PositionState& state,
                              int maxDepth = 20, int maxTimeMs = 5000);
     
     // Reset licznika węzłów
-    void resetNodesCount() { nodesVisited = 0; }
+    void resetNodesCount() {
+        nodesVisited = 0; ttProbes = 0; ttHits = 0; evalProbes = 0; evalHits = 0;
+        pawnTable.resetStats();
+    }
     
-    // Pobierz liczbę odwiedzonych węzłów
+    // Pobierz liczbę odwiedzonych węzłów (suma ze wszystkich wątków)
     uint64_t getNodesVisited() const { return nodesVisited; }
+    // Odsetek trafień w TT w ostatnim wyszukiwaniu (wszystkie wątki)
+    double getTTHitRate() const { return ttProbes ? static_cast<double>(ttHits) / ttProbes : 0.0; }
+    // Odsetek trafień w tablicy hash pionów w ostatnim wyszukiwaniu (wszystkie wątki)
+    double getPawnHitRate() const { return pawnProbes ? static_cast<double>(pawnHits) / pawnProbes : 0.0; }
+    // Odsetek ocen statycznych wziętych z cache oceny (wszystkie wątki)
+    double getEvalHitRate() const { return evalProbes ? static_cast<double>(evalHits) / evalProbes : 0.0; }
+    
+    // Liczba wątków wyszukiwania (Lazy SMP, wspólna TT)
+    void setThreads(int threads) { threadCount = threads < 1 ? 1 : threads; }
+    int getThreads() const { return threadCount; }
+    // Wypisywanie postępu kolejnych głębokości
+    void setVerbose(bool v) { verbose = v; }
+    
+    // Rozmiar TT w MB; realokacja tylko przy zmianie rozmiaru (nie wywoływać w trakcie wyszukiwania).
+    // false przy braku pamięci - TT zostaje w dotychczasowym rozmiarze
+    bool setHashSize(size_t sizeMb) { return transpositionTable->resize(sizeMb); }
+    size_t getHashSizeMb() const { return transpositionTable->sizeMb(); }
+    HugePages hashHugePages() const { return transpositionTable->hugePageMode(); }
     
     // Wyczyść tablicę transpozycji
-    void clearTranspositionTable() { transpositionTable.clear(); }
+    void clearTranspositionTable() { transpositionTable->clear(); }
+    // Nowa partia: wyniki z poprzedniej nie dotyczą już pozycji na planszy
+    void newGame() { clearTranspositionTable(); }
 };
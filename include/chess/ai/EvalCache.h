@@ -0,0 +1,38 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Pamięć podręczna oceny statycznej (Evaluator::evaluatePosition), indeksowana hashem Zobrista.
+// Direct-mapped: jeden wpis na indeks, nowy wynik zawsze nadpisuje stary.
+// Wpis to jedno 64-bitowe słowo atomowe: 48 najstarszych bitów hasha | ocena (16 bitów),
+// z perspektywy strony na ruchu (hash zawiera klucz strony, więc ta sama plansza z drugą
+// stroną na ruchu to inny wpis). Odczyt i zapis relaxed - tablicę można współdzielić
+// między wątkami bez blokad, jak TT.
+class EvalCache {
+public:
+    static constexpr size_t SIZE = 1 << 15;   // liczba wpisów (256 KB)
+
+    EvalCache() : entries(std::make_unique<std::atomic<uint64_t>[]>(SIZE)) { clear(); }
+
+    bool probe(uint64_t hash, int& score) const {
+        uint64_t word = entries[hash & (SIZE - 1)].load(std::memory_order_relaxed);
+        if (!word || (word ^ hash) >> 16) return false;
+        score = static_cast<int16_t>(word & 0xFFFF);
+        return true;
+    }
+
+    void store(uint64_t hash, int score) {
+        int16_t clamped = static_cast<int16_t>(std::clamp(score, INT16_MIN + 1, INT16_MAX));
+        uint64_t word = (hash & ~uint64_t(0xFFFF)) | static_cast<uint16_t>(clamped);
+        entries[hash & (SIZE - 1)].store(word, std::memory_order_relaxed);
+    }
+
+    void clear() {
+        for (size_t i = 0; i < SIZE; i++) entries[i].store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> entries;
+};
@@ -1,8 +1,12 @@
 #pragma once
 #include "chess/board/Board.h"
+#include "chess/board/Position.h"
+#include "chess/ai/PawnHashTable.h"
 
 namespace Evaluator {
     // Ocena pozycji z perspektywy białych (pozytywna = białe lepsze, negatywna = czarne lepsze)
+    // Z pawnTable ocena pionów (struktura + osłona króla) brana z tablicy hash pionów
+    int evaluatePosition(const Position& pos, char activeColor, PawnHashTable* pawnTable = nullptr);
     int evaluatePosition(const char board[8][8], char activeColor);
     
     // Wartości figur w centipawnach
@@ -12,14 +16,26 @@ namespace Evaluator {
     constexpr int ROOK_VALUE = 500;
     constexpr int QUEEN_VALUE = 900;
     constexpr int KING_VALUE = 20000;
+    // Te same wartości według PieceType - jedna tabela dla oceny, SEE i MovePicker
+    constexpr int PIECE_VALUES[6] = {PAWN_VALUE, KNIGHT_VALUE, BISHOP_VALUE,
+                                     ROOK_VALUE, QUEEN_VALUE, KING_VALUE};
+    constexpr int pieceValue(PieceType pt) { return PIECE_VALUES[pt]; }
+    // Wartość bierki z planszy (litera jak na board[][]); 0 dla braku bierki
+    constexpr int pieceValue(char piece) { return piece ? PIECE_VALUES[typeOf(pieceIndex(piece))] : 0; }
     
     // Bonusy pozycyjne
     constexpr int CENTER_CONTROL_BONUS = 10;
-    constexpr int PAWN_STRUCTURE_BONUS = 5;
+    constexpr int PAWN_STRUCTURE_BONUS = 5;       // kara za każdy podwójny pion
+    constexpr int ISOLATED_PAWN_PENALTY = 10;     // brak własnych pionów na sąsiednich liniach
+    constexpr int PASSED_PAWN_BONUS[6] = {5, 10, 20, 35, 60, 100};   // wg pól przebytych od startu
+    constexpr int PAWN_SHIELD_BONUS = 8;          // własny pion przed królem (2 rzędy, 3 linie)
     constexpr int KING_SAFETY_BONUS = 20;
+    constexpr int KING_ZONE_ATTACK_PENALTY = 6;   // za każde atakowane pole wokół króla
     
     // Funkcje pomocnicze
-    int evaluatePawnStructure(const char board[8][8]);
-    int evaluateCenterControl(const char board[8][8]);
-    int evaluateKingSafety(const char board[8][8]);
+    int evaluatePawnStructure(const Position& pos);           // podwójne, izolowane, wolne
+    int evaluatePawnShield(const Position& pos, Color color);  // z perspektywy danej strony
+    int evaluatePawns(const Position& pos, PawnHashTable* pawnTable);
+    int evaluateCenterControl(const Position& pos);
+    int evaluateKingSafety(const Position& pos);
 }
@@ -0,0 +1,45 @@
+#pragma once
+#include "chess/board/Position.h"
+#include "chess/model/MoveList.h"
+#include "chess/model/PackedMove.h"
+#include "chess/rules/MoveGenerator.h"
+
+// Etapowy wybór ruchów dla negamax: ruch z TT, dobre bicia (MVV-LVA, SEE >= 0), killery,
+// ciche, na końcu bicia przegrywające materiał (SEE < 0).
+// Każdy etap generujemy dopiero, gdy wyszukiwanie do niego dojdzie - w węzłach z odcięciem
+// na pierwszym ruchu nie generujemy ruchów cichych wcale.
+class MovePicker {
+public:
+    MovePicker(const Position& pos, PackedMove ttMove, const PackedMove killers[2]);
+    // Quiescence: tylko bicia i promocje, bez przegrywających materiał (SEE < 0), chyba że szachują
+    explicit MovePicker(const Position& pos);
+
+    // Następny legalny ruch; false, gdy ruchy się skończyły
+    bool next(Move& move);
+
+private:
+    enum Stage { TT_MOVE, GEN_CAPTURES, GOOD_CAPTURES, KILLERS, GEN_QUIETS, QUIETS, BAD_CAPTURES,
+                 QS_GEN_CAPTURES, QS_CAPTURES, DONE };
+
+    bool isUsable(PackedMove m) const;        // ruch spoza generatora: pseudo-legalny i legalny
+    void scoreCaptures();
+    void scoreQuiets();
+    const Move& pickBest();                   // najlepszy z pozostałych (sortowanie przez wybór)
+
+    const Position& pos;
+    PackedMove ttMove;
+    PackedMove killers[2];
+    Stage stage{TT_MOVE};
+
+    MoveList moves;
+    int scores[MoveList::MAX_MOVES];
+    int current{0};
+    int killerIndex{0};
+
+    // Bicia z SEE < 0 odłożone na koniec (lista ruchów zostaje nadpisana cichymi)
+    PackedMove badCaptures[MoveList::MAX_MOVES];
+    int badCount{0};
+    int badIndex{0};
+
+    CheckInfo checkInfo;                      // quiescence: szachujących bić nie odrzucamy
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+// Pamięć podręczna oceny struktury pionów, indeksowana kluczem Position::pawnHash.
+// Piony zmieniają się tylko przy ruchach pionów i ich biciu, więc w wyszukiwaniu prawie
+// każda ocena trafia w gotowy wpis. Tablica mała (256 KB, mieści się w L2) i prywatna
+// dla jednego wyszukiwania (wątku) - bez synchronizacji.
+class PawnHashTable {
+public:
+    static constexpr size_t SIZE = 1 << 14;   // liczba wpisów (potęga dwójki)
+    static constexpr int8_t NOT_COMPUTED = -2; // osłona jeszcze nie policzona (NO_SQUARE = brak króla)
+
+    // Pusty wpis (klucz 0, ocena 0) jest poprawny dla pozycji bez pionów
+    struct Entry {
+        uint64_t key{0};
+        int16_t score{0};           // podwójne, izolowane, wolne piony (z perspektywy białych)
+        int8_t kingSq[2]{NOT_COMPUTED, NOT_COMPUTED};   // pola królów, dla których liczono osłonę
+        int16_t shield[2]{0, 0};    // osłona pionowa króla danej strony (dodatnia = dobra)
+    };
+
+    PawnHashTable() : entries(std::make_unique<Entry[]>(SIZE)) {}
+
+    // Wpis dla klucza; found = false - wpis wyczyszczony pod nowy klucz, score trzeba policzyć
+    Entry& probe(uint64_t key, bool& found) {
+        Entry& e = entries[key & (SIZE - 1)];
+        probes++;
+        found = e.key == key;
+        if (found) {
+            hits++;
+        } else {
+            e = Entry{};
+            e.key = key;
+        }
+        return e;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < SIZE; i++) entries[i] = Entry{};
+    }
+
+    void resetStats() { probes = hits = 0; }
+    uint64_t getProbes() const { return probes; }
+    uint64_t getHits() const { return hits; }
+
+private:
+    std::unique_ptr<Entry[]> entries;
+    uint64_t probes{0};
+    uint64_t hits{0};
+};
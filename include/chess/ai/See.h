@@ -0,0 +1,11 @@
+#pragma once
+#include "chess/board/Position.h"
+#include "chess/model/Move.h"
+
+// Static Exchange Evaluation: bilans materialny serii bić na polu docelowym ruchu,
+// gdy obie strony biją zawsze najtańszą bierką i mogą w każdej chwili przestać.
+// Uwzględnia ataki "zza pleców" (x-ray) figur dalekosiężnych; związania pomija.
+namespace See {
+    // Zysk strony wykonującej ruch w centypionach (ujemny = bicie przegrywa materiał)
+    int evaluate(const Position& pos, const Move& move);
+}
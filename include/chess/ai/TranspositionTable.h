@@ -1,7 +1,8 @@
 #pragma once
-#include <unordered_map>
-#include <string>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include "chess/model/PackedMove.h"
 
 enum class NodeType {
     EXACT,      // Dokładna wartość
@@ -9,25 +10,111 @@ enum class NodeType {
     BETA        // Dolna granica (beta cutoff)
 };
 
-struct TranspositionEntry {
-    int depth;
-    int score;
-    NodeType nodeType;
-    uint64_t zobristHash;
-    
-    TranspositionEntry() : depth(0), score(0), nodeType(NodeType::EXACT), zobristHash(0) {}
-    TranspositionEntry(int d, int s, NodeType nt, uint64_t zh) 
-        : depth(d), score(s), nodeType(nt), zobristHash(zh) {}
-};
+// Strony huge pod TT: ADVISED - madvise(MADV_HUGEPAGE) przyjęte, ale czy pamięć dostanie
+// strony huge, decyduje THP w jądrze (madvise udaje się też przy THP "never");
+// RESERVED - pamięć z mmap(MAP_HUGETLB), strony huge na pewno
+enum class HugePages { NONE, ADVISED, RESERVED };
 
+// Tablica transpozycji o stałym rozmiarze: 2^n kubełków po 64 bajty (jedna linia cache),
+// w każdym 8 spakowanych 8-bajtowych wpisów. Kubełek wybierają młodsze bity hasha,
+// wpis rozpoznajemy po 16 najstarszych. Probe i store to O(1) - przegląd jednego kubełka.
+// Wymiana: najpierw ten sam klucz albo pusty wpis, potem najpłytszy / najstarszy (depth-preferred).
+// Wpis niesie też najlepszy ruch (lub ruch odcięcia) - wyszukiwanie próbuje go jako pierwszego,
+// także gdy wpis jest za płytki na odcięcie.
+//
+// Współdzielona przez wątki wyszukiwania bez blokad: cały wpis to jedno 64-bitowe słowo
+// atomowe (relaxed), więc odczyt nigdy nie widzi połowy zapisu innego wątku. Wyścig dwóch
+// zapisów do tego samego kubełka najwyżej zgubi jeden wynik - dla TT to dopuszczalne.
+// resize/clear nie są bezpieczne w trakcie wyszukiwania.
+//
+// Pamięć wyrównana do 2 MB; na Linuksie prosimy o strony huge (madvise(MADV_HUGEPAGE),
+// a gdy THP wyłączone lub niedostępne - mmap(MAP_HUGETLB)) - losowe probe nie zapychają wtedy TLB.
 class TranspositionTable {
-private:
-    std::unordered_map<uint64_t, TranspositionEntry> table;
-    static constexpr size_t MAX_SIZE = 1000000; // Maksymalny rozmiar tablicy
-    
 public:
-    void store(uint64_t hash, int depth, int score, NodeType nodeType);
-    bool probe(uint64_t hash, int depth, int& score, NodeType& nodeType);
-    void clear();
-    size_t size() const { return table.size(); }
+    static constexpr size_t DEFAULT_SIZE_MB = 16;
+    static constexpr size_t MAX_SIZE_MB = 32768;   // większe wartości obcinamy
+#if defined(CHESS_TT_PREFETCH) && (defined(__GNUC__) || defined(__clang__))
+    static constexpr bool PREFETCH_ENABLED = true;
+#else
+    static constexpr bool PREFETCH_ENABLED = false;
+#endif
+
+    explicit TranspositionTable(size_t sizeMb = DEFAULT_SIZE_MB);
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Nowy rozmiar w MB (obcięty do 1..MAX_SIZE_MB, zaokrąglony w dół do potęgi dwójki kubełków).
+    // Alokuje i czyści tylko przy zmianie rozmiaru - ten sam rozmiar zostawia tablicę i jej
+    // zawartość. false, gdy brak pamięci - wtedy zostaje dotychczasowa tablica
+    bool resize(size_t sizeMb);
+    // Bez ruchu (PackedMove()) zachowujemy ruch zapisany wcześniej dla tej samej pozycji
+    void store(uint64_t hash, int depth, int score, NodeType nodeType, PackedMove move = PackedMove());
+    // true, gdy wpis ma głębokość >= depth (score/nodeType ważne); move ustawiany przy każdym
+    // trafieniu klucza (PackedMove(), gdy brak)
+    bool probe(uint64_t hash, int depth, int& score, NodeType& nodeType, PackedMove& move) const;
+    // Sam ruch z wpisu - porządkowanie ruchów w korzeniu
+    PackedMove probeMove(uint64_t hash) const;
+    // Ściągnij kubełek do cache zawczasu (hash dziecka znany zaraz po makeMove) - probe
+    // w węźle potomnym nie czeka wtedy na pamięć. Tylko gdy PREFETCH_ENABLED.
+    void prefetch(uint64_t hash) const {
+        if constexpr (PREFETCH_ENABLED) {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(&buckets[hash & mask]);
+#endif
+        }
+        (void)hash;
+    }
+    void clear();   // bez realokacji
+    // Początek kolejnego wyszukiwania: wpisy z poprzednich zostają (rozgrzewają wyszukiwanie
+    // po następnym ruchu), ale przy wymianie idą na pierwszy ogień
+    void newSearch() { generation = (generation + 1) & 63; }
+
+    size_t capacity() const { return bucketCount * ENTRIES_PER_BUCKET; }   // liczba wpisów
+    size_t sizeMb() const { return bucketCount * sizeof(Bucket) >> 20; }
+    HugePages hugePageMode() const { return hugePages; }
+
+private:
+    // Bity słowa: key16 | move16 | score16 | depth8 | genBound8 (6 bitów pokolenia, 2 bity typu; 0 = pusty)
+    struct Entry {
+        uint16_t key16{0};
+        uint16_t move16{0};   // PackedMove::raw(), 0 = brak
+        int16_t score{0};
+        uint8_t depth{0};
+        uint8_t genBound{0};
+
+        bool empty() const { return (genBound & 3) == 0; }
+        NodeType bound() const { return static_cast<NodeType>((genBound & 3) - 1); }
+        uint8_t generation() const { return genBound >> 2; }
+
+        static Entry unpack(uint64_t w) {
+            return {static_cast<uint16_t>(w), static_cast<uint16_t>(w >> 16), static_cast<int16_t>(w >> 32),
+                    static_cast<uint8_t>(w >> 48), static_cast<uint8_t>(w >> 56)};
+        }
+        uint64_t pack() const {
+            return uint64_t(key16) | uint64_t(move16) << 16 | uint64_t(uint16_t(score)) << 32 |
+                   uint64_t(depth) << 48 | uint64_t(genBound) << 56;
+        }
+    };
+
+    static constexpr int ENTRIES_PER_BUCKET = 8;
+    struct alignas(64) Bucket {
+        std::atomic<uint64_t> entries[ENTRIES_PER_BUCKET];
+    };
+    static_assert(sizeof(Bucket) == 64, "kubełek TT musi zajmować jedną linię cache");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "wpis TT musi być atomowy bez blokad");
+
+    Bucket& bucketFor(uint64_t hash) const { return buckets[hash & mask]; }
+    static uint16_t keyOf(uint64_t hash) { return static_cast<uint16_t>(hash >> 48); }
+
+    bool allocate(size_t count);   // podmienia tablicę tylko po udanej alokacji
+    void release();
+
+    Bucket* buckets{nullptr};
+    size_t bucketCount{0};
+    size_t allocBytes{0};
+    bool mapped{false};      // pamięć z mmap(MAP_HUGETLB), zwalniana munmap
+    HugePages hugePages{HugePages::NONE};
+    uint64_t mask{0};
+    uint8_t generation{0};   // 6 bitów; wpisy z innego pokolenia wymieniamy chętniej
 };
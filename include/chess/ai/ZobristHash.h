@@ -1,24 +1,82 @@
 #pragma once
+#include <array>
 #include <cstdint>
-#include <random>
+#include "chess/board/Position.h"
+
+// Klucze Zobrista liczone w czasie kompilacji ze stałego ziarna - te same w każdym procesie
+// i na każdej maszynie (można współdzielić/zapisywać dane indeksowane hashem), bez pracy przy starcie.
+// Układ 781 kluczy jak w Polyglot: 768 figur (rodzaj 0-11: czarny pion, biały pion, czarny skoczek, ...,
+// biały król; pole = 8 * linia + kolumna, a1 = 0), 4 roszady (K, Q, k, q), 8 kolumn EP, strona.
+// Same wartości pochodzą z naszego generatora (splitmix64), nie z tablicy Random64 Polyglota.
+namespace ZobristKeys {
+    constexpr int PIECES   = 0;
+    constexpr int CASTLING = 768;
+    constexpr int EN_PASSANT = 772;
+    constexpr int TURN     = 780;
+    constexpr int COUNT    = 781;
+
+    constexpr uint64_t SEED = 0x5A6F627269737421ULL;   // "Zobrist!"
+
+    constexpr std::array<uint64_t, COUNT> generate() {
+        std::array<uint64_t, COUNT> keys{};
+        uint64_t state = SEED;
+        for (uint64_t& key : keys) {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key = z ^ (z >> 31);
+        }
+        return keys;
+    }
+
+    inline constexpr std::array<uint64_t, COUNT> RANDOM64 = generate();
+
+    // Nasz indeks bierki (P..K białe 0-5, czarne 6-11) i pole (a8 = 0) -> indeks Polyglot
+    constexpr int polyglotIndex(int piece, int sq) {
+        int kind = 2 * typeOf(piece) + (colorOf(piece) == WHITE ? 1 : 0);
+        int rank = 7 - Bitboards::rowOf(sq);
+        return PIECES + 64 * kind + 8 * rank + Bitboards::colOf(sq);
+    }
+
+    // Tablice w naszym układzie, żeby gorąca ścieżka (makeMove) nie przeliczała indeksów
+    struct Tables {
+        uint64_t piece[12][64]{};
+        uint64_t castling[16]{};   // XOR kluczy praw z maski CASTLE_* (jak w Polyglot)
+        uint64_t enPassant[8]{};
+        uint64_t side{0};          // Polyglot: XOR, gdy ruch mają białe
+    };
+
+    constexpr Tables build() {
+        Tables t{};
+        for (int piece = 0; piece < 12; ++piece)
+            for (int sq = 0; sq < 64; ++sq)
+                t.piece[piece][sq] = RANDOM64[polyglotIndex(piece, sq)];
+        for (int mask = 0; mask < 16; ++mask)
+            for (int bit = 0; bit < 4; ++bit)
+                if (mask & (1 << bit)) t.castling[mask] ^= RANDOM64[CASTLING + bit];
+        for (int file = 0; file < 8; ++file)
+            t.enPassant[file] = RANDOM64[EN_PASSANT + file];
+        t.side = RANDOM64[TURN];
+        return t;
+    }
+
+    inline constexpr Tables TABLES = build();
+}
+
+static_assert(ZobristKeys::TABLES.castling[0] == 0, "brak praw roszady nie zmienia hasha");
+static_assert(ZobristKeys::polyglotIndex(makePiece(WHITE, KING), 63) == 64 * 11 + 7, "biały król na h1");
 
 class ZobristHash {
-private:
-    static uint64_t pieceKeys[12][8][8];  // 12 typów figur (6 białe + 6 czarne) × 8×8 pól
-    static uint64_t sideToMoveKey;        // Klucz dla strony do ruchu
-    static uint64_t castlingKeys[16];     // Klucze dla wszystkich kombinacji roszad
-    static uint64_t enPassantKeys[8];    // Klucze dla en passant
-    
-    static bool initialized;
-    
 public:
-    static void initialize();
-    static uint64_t calculateHash(const char board[8][8], char activeColor, 
-                                 const std::string& castling, const std::string& enPassant);
+    static uint64_t calculateHash(const Position& pos);   // stan brany z pos (strona, roszady, EP)
+    static uint64_t calculatePawnHash(const Position& pos);   // tylko piony obu stron (te same klucze)
+    static uint64_t calculateHash(const char board[8][8], char activeColor, const PositionState& state);
     static uint64_t updateHash(uint64_t currentHash, const char board[8][8], 
-                              char activeColor, const std::string& castling, 
-                              const std::string& enPassant);
+                              char activeColor, const PositionState& state);
     
-private:
-    static uint64_t getRandomUint64();
+    // Pojedyncze klucze - do przyrostowej aktualizacji w Position::makeMove (XOR zmienionych składników)
+    static constexpr uint64_t pieceKey(int piece, int sq) { return ZobristKeys::TABLES.piece[piece][sq]; }
+    static constexpr uint64_t castlingKey(uint8_t castling) { return ZobristKeys::TABLES.castling[castling]; }
+    static constexpr uint64_t enPassantKey(int epSquare) { return ZobristKeys::TABLES.enPassant[epSquare & 7]; }
+    static constexpr uint64_t sideKey() { return ZobristKeys::TABLES.side; }
 };
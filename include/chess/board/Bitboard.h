@@ -0,0 +1,84 @@
+// Bitboard.h
+#pragma once
+#include <bit>
+#include <cstdint>
+
+// Bitboard: bit nr sq odpowiada polu board[sq / 8][sq % 8]
+// (sq = row * 8 + col, czyli a8 = 0, h8 = 7, a1 = 56, h1 = 63)
+using Bitboard = uint64_t;
+
+enum Color : int { WHITE = 0, BLACK = 1 };
+
+// Typy figur; indeks bierki = kolor * 6 + typ (0-5 białe P,N,B,R,Q,K, 6-11 czarne)
+enum PieceType : int { PAWN = 0, KNIGHT, BISHOP, ROOK, QUEEN, KING };
+
+constexpr int NO_PIECE = -1;
+constexpr int NO_SQUARE = -1;
+
+constexpr Color operator~(Color c) { return Color(c ^ 1); }
+constexpr Color toColor(char activeColor) { return activeColor == 'w' ? WHITE : BLACK; }
+constexpr char toColorChar(Color c) { return c == WHITE ? 'w' : 'b'; }
+
+// 'P' -> 0, 'n' -> 7, 0 -> NO_PIECE
+constexpr int pieceIndex(char piece) {
+    switch (piece) {
+        case 'P': return 0;  case 'N': return 1;  case 'B': return 2;
+        case 'R': return 3;  case 'Q': return 4;  case 'K': return 5;
+        case 'p': return 6;  case 'n': return 7;  case 'b': return 8;
+        case 'r': return 9;  case 'q': return 10; case 'k': return 11;
+        default:  return NO_PIECE;
+    }
+}
+constexpr char pieceChar(int index) { return "PNBRQKpnbrqk"[index]; }
+constexpr int makePiece(Color c, PieceType pt) { return c * 6 + pt; }
+constexpr PieceType typeOf(int index) { return PieceType(index % 6); }
+constexpr Color colorOf(int index) { return index < 6 ? WHITE : BLACK; }
+
+namespace Bitboards {
+
+    constexpr int square(int row, int col) { return row * 8 + col; }
+    constexpr int rowOf(int sq) { return sq >> 3; }
+    constexpr int colOf(int sq) { return sq & 7; }
+    constexpr Bitboard squareBB(int sq) { return Bitboard(1) << sq; }
+
+    constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+    constexpr Bitboard FILE_H = FILE_A << 7;
+    constexpr Bitboard ROW_0  = 0xFFULL;              // 8. linia
+    constexpr Bitboard ROW_7  = ROW_0 << 56;          // 1. linia
+    constexpr Bitboard fileBB(int col) { return FILE_A << col; }
+    constexpr Bitboard rowBB(int row) { return ROW_0 << (8 * row); }
+
+    inline int popCount(Bitboard b) { return std::popcount(b); }
+    inline int lsb(Bitboard b) { return std::countr_zero(b); }
+    inline int popLsb(Bitboard& b) {
+        int sq = lsb(b);
+        b &= b - 1;
+        return sq;
+    }
+    constexpr bool moreThanOne(Bitboard b) { return (b & (b - 1)) != 0; }
+
+    // Przesunięcia o jedno pole (w górę = w stronę 8. linii, czyli row - 1)
+    constexpr Bitboard north(Bitboard b) { return b >> 8; }
+    constexpr Bitboard south(Bitboard b) { return b << 8; }
+    constexpr Bitboard east(Bitboard b)  { return (b << 1) & ~FILE_A; }
+    constexpr Bitboard west(Bitboard b)  { return (b >> 1) & ~FILE_H; }
+
+    // Ataki wielu figur naraz (set-wise), bez tablic i bez sprawdzania granic
+    constexpr Bitboard pawnAttacks(Bitboard pawns, Color c) {
+        return c == WHITE ? west(north(pawns)) | east(north(pawns))
+                          : west(south(pawns)) | east(south(pawns));
+    }
+
+    constexpr Bitboard knightAttacks(Bitboard b) {
+        Bitboard l1 = (b >> 1) & ~FILE_H, l2 = (b >> 2) & ~(FILE_H | (FILE_H >> 1));
+        Bitboard r1 = (b << 1) & ~FILE_A, r2 = (b << 2) & ~(FILE_A | (FILE_A << 1));
+        Bitboard h1 = l1 | r1, h2 = l2 | r2;
+        return (h1 << 16) | (h1 >> 16) | (h2 << 8) | (h2 >> 8);
+    }
+
+    constexpr Bitboard kingAttacks(Bitboard b) {
+        Bitboard row = b | east(b) | west(b);
+        return (row | north(row) | south(row)) & ~b;
+    }
+
+} // namespace Bitboards
@@ -12,11 +12,9 @@ public:
     // Dane pozycji
     char board[8][8]{};      // 0 = puste, inaczej litera figury
     char activeColor{'w'};   // 'w' / 'b'
-    std::string castling{"KQkq"};
-    std::string enPassant{"-"};  // np. "e3" lub "-"
-    int halfmoveClock{0};
-    int fullmoveNumber{1};
+    PositionState state;     // roszady (maska), pole EP, liczniki - napisy tylko przy FEN
 
+    Position position;                 // bitboardy zsynchronizowane z board (generator, AI)
     GameStateManager gameStateManager; // możesz dać do private, jeśli wolisz
 
     std::vector<Move> getLegalMoves() const;
@@ -30,6 +28,10 @@ public:
     void startBoard();           // inicjalizacja z FEN
     void setPositionFromFEN(const std::string& fen);  // ustaw pozycję z FEN
     void printBoard() const;
+    void syncPosition() {        // po każdej zmianie board lub stanu
+        position.setFromMailbox(board);
+        position.setState(toColor(activeColor), state);
+    }
 
     // Logika — dalej implementacje w osobnych .cpp
     bool isPathClear(int r1, int c1, int r2, int c2) const;
@@ -0,0 +1,82 @@
+// Position.h
+#pragma once
+#include <cstdint>
+#include "chess/board/Bitboard.h"
+#include "chess/board/PositionState.h"
+#include "chess/model/Move.h"
+
+// Rekord cofania ruchu - wszystko, czego nie da się odtworzyć z samego ruchu
+struct UndoInfo {
+    uint64_t hash;
+    uint64_t pawnHash;
+    PositionState state;
+    char moved;         // bierka na polu startowym (pion przy promocji)
+    char captured;
+};
+
+// Pozycja dla generatora ruchów i AI: mailbox + 12 bitboardów figur + zajętość.
+// Obie reprezentacje są zawsze zgodne - zmieniamy je tylko przez putPiece/removePiece/movePiece.
+class Position {
+public:
+    static constexpr int MAX_PLY = 256;  // maksymalna liczba ruchów wykonanych bez cofnięcia
+
+    char board[8][8]{};        // 0 = puste, inaczej litera figury (jak Board::board)
+    Bitboard pieces[12]{};     // indeksy jak pieceIndex(): P,N,B,R,Q,K,p,n,b,r,q,k
+    Bitboard colors[2]{};      // wszystkie figury białych / czarnych
+    Bitboard occupied{0};
+
+    // Stan pozycji
+    Color sideToMove{WHITE};
+    PositionState state{0, NO_SQUARE, 0, 1};  // roszady, EP, liczniki
+    uint64_t hash{0};           // klucz Zobrista, aktualizowany przez makeMove/unmakeMove
+    uint64_t pawnHash{0};       // klucz samych pionów (obu stron) - indeks tablicy hash pionów
+
+    Position() = default;
+    explicit Position(const char src[8][8]) { setFromMailbox(src); }
+
+    void setFromMailbox(const char src[8][8]);
+    // Ustawia stronę na ruchu i stan pozycji, przelicza hash
+    void setState(Color side, const PositionState& st);
+
+    // Ruch w miejscu + cofnięcie; stos rekordów cofania ma stały rozmiar (MAX_PLY)
+    void makeMove(const Move& move);
+    void unmakeMove(const Move& move);
+    int ply() const { return undoCount; }
+
+    char pieceAt(int sq) const { return board[sq >> 3][sq & 7]; }
+    Bitboard piecesOf(Color c, PieceType pt) const { return pieces[makePiece(c, pt)]; }
+    int kingSquare(Color c) const {
+        Bitboard k = pieces[makePiece(c, KING)];
+        return k ? Bitboards::lsb(k) : NO_SQUARE;
+    }
+
+    void putPiece(char piece, int sq) {
+        Bitboard b = Bitboards::squareBB(sq);
+        int idx = pieceIndex(piece);
+        board[sq >> 3][sq & 7] = piece;
+        pieces[idx] |= b;
+        colors[colorOf(idx)] |= b;
+        occupied |= b;
+    }
+
+    void removePiece(int sq) {
+        char piece = pieceAt(sq);
+        if (!piece) return;
+        Bitboard b = Bitboards::squareBB(sq);
+        int idx = pieceIndex(piece);
+        board[sq >> 3][sq & 7] = 0;
+        pieces[idx] ^= b;
+        colors[colorOf(idx)] ^= b;
+        occupied ^= b;
+    }
+
+    void movePiece(int from, int to) {
+        char piece = pieceAt(from);
+        removePiece(from);
+        putPiece(piece, to);
+    }
+
+private:
+    UndoInfo undoStack[MAX_PLY];
+    int undoCount{0};
+};
@@ -0,0 +1,20 @@
+// PositionState.h
+#pragma once
+#include <cstdint>
+#include "chess/board/Bitboard.h"
+
+// Prawa do roszady jako maska bitowa (bity zgodne z indeksem kluczy roszad Zobrista)
+constexpr uint8_t CASTLE_WK = 1;   // K
+constexpr uint8_t CASTLE_WQ = 2;   // Q
+constexpr uint8_t CASTLE_BK = 4;   // k
+constexpr uint8_t CASTLE_BQ = 8;   // q
+constexpr uint8_t CASTLE_ALL = CASTLE_WK | CASTLE_WQ | CASTLE_BK | CASTLE_BQ;
+
+// Stan pozycji poza ustawieniem bierek - bez alokacji, kopiowany po wartości.
+// Napisy FEN ("KQkq", "e3") zamieniamy na ten stan tylko na brzegach (FEN, MQTT, CLI).
+struct PositionState {
+    uint8_t castling{CASTLE_ALL};  // maska CASTLE_*
+    int8_t epSquare{NO_SQUARE};    // pole bicia w przelocie albo NO_SQUARE
+    int halfmoveClock{0};
+    int fullmoveNumber{1};
+};
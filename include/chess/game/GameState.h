@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <unordered_map>
+#include "chess/board/Position.h"
 
 enum class GameState {
     PLAYING,
@@ -15,17 +16,14 @@ class GameStateManager {
 private:
     std::unordered_map<std::string, int> positionHistory;
     
-    bool hasInsufficientMaterial(const char board[8][8]) const;
-    std::string boardToString(const char board[8][8], char activeColor, 
-                             const std::string& castling, const std::string& enPassant) const;
+    bool hasInsufficientMaterial(const Position& pos) const;
+    std::string boardToString(const Position& pos) const;
 
 public:
-    void addPosition(const char board[8][8], char activeColor, 
-                    const std::string& castling, const std::string& enPassant);
+    // Strona na ruchu, roszady, EP i licznik półruchów brane ze stanu pozycji
+    void addPosition(const Position& pos);
     void clearHistory();
     
-    GameState checkGameState(const char board[8][8], char activeColor, 
-                           const std::string& castling, const std::string& enPassant,
-                           int halfmoveClock, bool hasLegalMoves, bool isInCheck) const;
+    GameState checkGameState(const Position& pos, bool hasLegalMoves, bool isInCheck) const;
     std::string getGameStateString(GameState state, char activeColor) const;
 };
\ No newline at end of file
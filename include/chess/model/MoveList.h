@@ -0,0 +1,32 @@
+// MoveList.h
+#pragma once
+#include <vector>
+#include "chess/model/Move.h"
+
+// Lista ruchów na stosie - bez alokacji na stercie w generatorze i w wyszukiwaniu.
+// 256 mieści każdą legalną pozycję (maksimum znane to 218 ruchów).
+class MoveList {
+public:
+    static constexpr int MAX_MOVES = 256;
+
+    void push_back(const Move& m) { moves[count++] = m; }
+    void clear() { count = 0; }
+    void resize(int n) { count = n; }   // tylko skracanie (filtrowanie w miejscu)
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    Move& operator[](int i) { return moves[i]; }
+    const Move& operator[](int i) const { return moves[i]; }
+
+    Move* begin() { return moves; }
+    Move* end() { return moves + count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+
+    std::vector<Move> toVector() const { return std::vector<Move>(begin(), end()); }
+
+private:
+    Move moves[MAX_MOVES];
+    int count{0};
+};
@@ -0,0 +1,74 @@
+// PackedMove.h
+#pragma once
+#include <cstdint>
+#include <string>
+#include "chess/model/Move.h"
+
+class Position;
+
+// Ruch zakodowany w 16 bitach:
+//   bity 0-5   pole startowe (row * 8 + col)
+//   bity 6-11  pole docelowe
+//   bity 12-13 figura promocji (0 = N, 1 = B, 2 = R, 3 = Q)
+//   bity 14-15 rodzaj ruchu (NORMAL, PROMOTION, EN_PASSANT, CASTLING)
+// Mieści się w TT i w listach sortowania; bierki odtwarzamy z pozycji (toMove).
+class PackedMove {
+public:
+    enum Type : uint16_t {
+        NORMAL     = 0 << 14,
+        PROMOTION  = 1 << 14,
+        EN_PASSANT = 2 << 14,
+        CASTLING   = 3 << 14
+    };
+
+    constexpr PackedMove() = default;
+    constexpr explicit PackedMove(uint16_t raw) : data(raw) {}
+    constexpr PackedMove(int from, int to, Type type = NORMAL, char promotion = 'Q')
+        : data(static_cast<uint16_t>(from | (to << 6) | (promoCode(promotion) << 12) | type)) {}
+
+    constexpr int from() const { return data & 0x3F; }
+    constexpr int to() const { return (data >> 6) & 0x3F; }
+    constexpr Type type() const { return static_cast<Type>(data & (3 << 14)); }
+    constexpr char promotion() const {       // wielka litera jak w generatorze, 0 gdy brak
+        return type() == PROMOTION ? "NBRQ"[(data >> 12) & 3] : 0;
+    }
+
+    constexpr uint16_t raw() const { return data; }
+    constexpr bool isNone() const { return data == 0; }   // a8a8 nie jest legalnym ruchem
+    constexpr bool operator==(const PackedMove& o) const { return data == o.data; }
+    constexpr bool operator!=(const PackedMove& o) const { return data != o.data; }
+
+    // Move -> 16 bitów; rodzaj ruchu wyznaczany z movedPiece/capturedPiece (jak z generatora)
+    static PackedMove fromMove(const Move& m);
+    // 16 bitów -> Move; bierki (ruszana, bita) brane z pozycji przed ruchem
+    Move toMove(const Position& pos) const;
+
+    // "e2e4", "e7e8q" (UCI, mała litera promocji) / "e7e8Q" (LAN jak w CLI)
+    std::string toUci() const;
+    std::string toLan() const;
+    // Parsuje UCI/LAN; rodzaj ruchu ustala na podstawie pozycji. Zwraca PackedMove() przy błędzie.
+    static PackedMove fromUci(const std::string& s, const Position& pos);
+
+private:
+    static constexpr uint16_t promoCode(char p) {
+        switch (p) {
+            case 'N': case 'n': return 0;
+            case 'B': case 'b': return 1;
+            case 'R': case 'r': return 2;
+            default:            return 3;
+        }
+    }
+
+    uint16_t data{0};
+};
+
+// Ruch + ocena w 32 bitach - do sortowania ruchów (więcej mieści się w cache niż Move)
+struct ScoredMove {
+    PackedMove move;
+    int16_t score{0};
+
+    bool operator<(const ScoredMove& o) const { return score < o.score; }
+};
+
+static_assert(sizeof(PackedMove) == 2, "PackedMove musi mieć 16 bitów");
+static_assert(sizeof(ScoredMove) == 4, "ScoredMove musi mieć 32 bity");
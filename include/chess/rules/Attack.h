@@ -1,10 +1,73 @@
 // Attack.h
 #pragma once
 #include "chess/board/Board.h"
+#include "chess/board/Position.h"
+#include "chess/rules/AttackTables.h"
+#include "chess/rules/Magic.h"
 
 namespace Attack {
     bool isPathClear(const char board[8][8], int r1, int c1, int r2, int c2);
     bool isSquareAttacked(const char board[8][8], int row, int col, char byColor);
+
+    // --- Wersje bitboardowe (gorąca ścieżka generatora i AI) ---
+    // Gońce i wieże z tablic magic bitboards (Magic.h)
+    inline Bitboard bishopAttacks(int sq, Bitboard occupied) { return Magic::bishopAttacks(sq, occupied); }
+    inline Bitboard rookAttacks(int sq, Bitboard occupied) { return Magic::rookAttacks(sq, occupied); }
+    inline Bitboard queenAttacks(int sq, Bitboard occupied) {
+        return bishopAttacks(sq, occupied) | rookAttacks(sq, occupied);
+    }
+
+    // Kolor atakującego w parametrze szablonu - bez rozgałęzień na kolor w gorącej ścieżce;
+    // wersja z Color wybiera specjalizację jeden raz
+    template <Color By> bool isSquareAttacked(const Position& pos, int sq);
+    bool isSquareAttacked(const Position& pos, int sq, Color byColor);
+    // Wszystkie pola atakowane przez stronę By - jedno przejście po bierkach zamiast
+    // osobnego skanu dla każdego pola (ruchy króla, roszada, szach, bezpieczeństwo króla)
+    template <Color By> Bitboard attackedBy(const Position& pos, Bitboard occupied);
+    Bitboard attackedBy(const Position& pos, Color byColor, Bitboard occupied);
+    // Wszystkie bierki (obu kolorów) atakujące pole przy podanej zajętości
+    Bitboard attackersTo(const Position& pos, int sq, Bitboard occupied);
+    // Bierki (obu kolorów) stojące jako jedyne między polem sq a figurą dalekosiężną strony by:
+    // dla naszego króla i figur przeciwnika - związania, dla króla przeciwnika i naszych - odsłony
+    Bitboard sliderBlockers(const Position& pos, int sq, Color by);
+
+    // Pola ściśle pomiędzy a i b / cała linia przez a i b (0, gdy nie leżą na jednej linii)
+    inline Bitboard between(int a, int b) { return AttackTables::between(a, b); }
+    inline Bitboard line(int a, int b) { return AttackTables::line(a, b); }
 }
 
+template <Color By>
+inline bool Attack::isSquareAttacked(const Position& pos, int sq) {
+    using namespace AttackTables;
 
+    // pion koloru By atakuje pole, jeśli stoi tam, gdzie "bije" pion przeciwnika z tego pola
+    if (pawnAttacks(~By, sq) & pos.piecesOf(By, PAWN)) return true;
+    if (knightAttacks(sq) & pos.piecesOf(By, KNIGHT)) return true;
+    if (kingAttacks(sq) & pos.piecesOf(By, KING)) return true;
+
+    Bitboard queens = pos.piecesOf(By, QUEEN);
+    Bitboard diag = pos.piecesOf(By, BISHOP) | queens;
+    if (diag && (bishopAttacks(sq, pos.occupied) & diag)) return true;
+    Bitboard straight = pos.piecesOf(By, ROOK) | queens;
+    if (straight && (rookAttacks(sq, pos.occupied) & straight)) return true;
+
+    return false;
+}
+
+template <Color By>
+inline Bitboard Attack::attackedBy(const Position& pos, Bitboard occupied) {
+    using namespace AttackTables;
+
+    Bitboard attacked = Bitboards::pawnAttacks(pos.piecesOf(By, PAWN), By);
+    for (Bitboard b = pos.piecesOf(By, KNIGHT); b; ) attacked |= knightAttacks(Bitboards::popLsb(b));
+
+    Bitboard queens = pos.piecesOf(By, QUEEN);
+    for (Bitboard b = pos.piecesOf(By, BISHOP) | queens; b; )
+        attacked |= bishopAttacks(Bitboards::popLsb(b), occupied);
+    for (Bitboard b = pos.piecesOf(By, ROOK) | queens; b; )
+        attacked |= rookAttacks(Bitboards::popLsb(b), occupied);
+
+    Bitboard king = pos.piecesOf(By, KING);
+    if (king) attacked |= kingAttacks(Bitboards::lsb(king));
+    return attacked;
+}
@@ -0,0 +1,88 @@
+// AttackTables.h
+#pragma once
+#include <array>
+#include "chess/board/Bitboard.h"
+
+// Tablice ataków i geometrii liczone w czasie kompilacji (constexpr) - zero pracy przy starcie
+// i brak sprawdzania granic planszy w gorących pętlach. Figury dalekosiężne: Magic.h.
+namespace AttackTables {
+
+    namespace detail {
+        using Table = std::array<Bitboard, 64>;
+        using PairTable = std::array<std::array<Bitboard, 64>, 64>;
+
+        template <typename Fn>
+        constexpr Table build(Fn fn) {
+            Table t{};
+            for (int sq = 0; sq < 64; ++sq) t[sq] = fn(Bitboards::squareBB(sq));
+            return t;
+        }
+
+        // Kierunek (dr, dc) z a do b, jeśli leżą na jednej linii (pion, poziom, skos)
+        constexpr bool direction(int a, int b, int& dr, int& dc) {
+            int r = Bitboards::rowOf(b) - Bitboards::rowOf(a);
+            int c = Bitboards::colOf(b) - Bitboards::colOf(a);
+            if (a == b || (r != 0 && c != 0 && r != c && r != -c)) return false;
+            dr = (r > 0) - (r < 0);
+            dc = (c > 0) - (c < 0);
+            return true;
+        }
+
+        constexpr PairTable buildBetween() {
+            PairTable t{};
+            for (int a = 0; a < 64; ++a) {
+                for (int b = 0; b < 64; ++b) {
+                    int dr = 0, dc = 0;
+                    if (!direction(a, b, dr, dc)) continue;
+                    for (int sq = a + dr * 8 + dc; sq != b; sq += dr * 8 + dc)
+                        t[a][b] |= Bitboards::squareBB(sq);
+                }
+            }
+            return t;
+        }
+
+        constexpr PairTable buildLine() {
+            PairTable t{};
+            for (int a = 0; a < 64; ++a) {
+                for (int b = 0; b < 64; ++b) {
+                    int dr = 0, dc = 0;
+                    if (!direction(a, b, dr, dc)) continue;
+                    // Od a w obie strony aż do krawędzi planszy
+                    for (int s = -1; s <= 1; s += 2) {
+                        int r = Bitboards::rowOf(a), c = Bitboards::colOf(a);
+                        while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+                            t[a][b] |= Bitboards::squareBB(Bitboards::square(r, c));
+                            r += s * dr; c += s * dc;
+                        }
+                    }
+                }
+            }
+            return t;
+        }
+    }
+
+    inline constexpr detail::Table KNIGHT_ATTACKS = detail::build([](Bitboard b) { return Bitboards::knightAttacks(b); });
+    inline constexpr detail::Table KING_ATTACKS   = detail::build([](Bitboard b) { return Bitboards::kingAttacks(b); });
+    // PAWN_ATTACKS[c][sq] - pola bite przez piona koloru c stojącego na sq
+    inline constexpr std::array<detail::Table, 2> PAWN_ATTACKS = {
+        detail::build([](Bitboard b) { return Bitboards::pawnAttacks(b, WHITE); }),
+        detail::build([](Bitboard b) { return Bitboards::pawnAttacks(b, BLACK); })
+    };
+
+    // BETWEEN[a][b] - pola ściśle pomiędzy a i b; LINE[a][b] - cała linia przez a i b (z nimi)
+    // Oba 0, gdy pola nie leżą na jednej linii
+    inline constexpr detail::PairTable BETWEEN = detail::buildBetween();
+    inline constexpr detail::PairTable LINE    = detail::buildLine();
+
+    constexpr Bitboard knightAttacks(int sq) { return KNIGHT_ATTACKS[sq]; }
+    constexpr Bitboard kingAttacks(int sq) { return KING_ATTACKS[sq]; }
+    constexpr Bitboard pawnAttacks(Color c, int sq) { return PAWN_ATTACKS[c][sq]; }
+    constexpr Bitboard between(int a, int b) { return BETWEEN[a][b]; }
+    constexpr Bitboard line(int a, int b) { return LINE[a][b]; }
+}
+
+// Kontrola w czasie kompilacji: skoczek z a8 (0) bije b6 (17) i c7 (10); e1 (60) - e8 (4) to jedna kolumna
+static_assert(AttackTables::knightAttacks(0) == (Bitboards::squareBB(17) | Bitboards::squareBB(10)));
+static_assert(AttackTables::between(60, 4) == (Bitboards::fileBB(4) & ~Bitboards::rowBB(0) & ~Bitboards::rowBB(7)));
+static_assert(AttackTables::line(0, 63) == 0x8040201008040201ULL);
+static_assert(AttackTables::between(0, 17) == 0);
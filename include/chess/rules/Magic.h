@@ -0,0 +1,46 @@
+// Magic.h
+#pragma once
+#include "chess/board/Bitboard.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Ataki figur dalekosiężnych (goniec, wieża) z tablic "magic bitboards".
+// Zajętość na promieniach (bez pól brzegowych) -> indeks w tablicy ataków:
+//   - z BMI2: _pext_u64(occupied, mask)
+//   - bez BMI2: ((occupied & mask) * magic) >> shift
+// Tablice budowane raz przy starcie programu (deterministyczne szukanie magii).
+namespace Magic {
+    struct Entry {
+        Bitboard mask;       // pola promieni bez brzegu
+        Bitboard magic;
+        Bitboard* attacks;   // wycinek wspólnej tablicy ataków dla tego pola
+        unsigned shift;
+
+        unsigned index(Bitboard occupied) const {
+#if defined(__BMI2__)
+            return static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+            return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+        }
+    };
+
+    extern Entry bishopEntries[64];
+    extern Entry rookEntries[64];
+
+    inline Bitboard bishopAttacks(int sq, Bitboard occupied) {
+        const Entry& e = bishopEntries[sq];
+        return e.attacks[e.index(occupied)];
+    }
+
+    inline Bitboard rookAttacks(int sq, Bitboard occupied) {
+        const Entry& e = rookEntries[sq];
+        return e.attacks[e.index(occupied)];
+    }
+
+    // Referencyjne ataki liczone promień po promieniu (budowa tablic, sprawdzanie)
+    Bitboard slowBishopAttacks(int sq, Bitboard occupied);
+    Bitboard slowRookAttacks(int sq, Bitboard occupied);
+}
@@ -1,28 +1,94 @@
 #pragma once
 #include <vector>
-#include <string>
 #include "chess/model/Move.h"
+#include "chess/model/MoveList.h"
+#include "chess/board/Position.h"
 
+// Które ruchy generować: wszystkie, tylko bicia i promocje, tylko ciche (z roszadą),
+// ucieczki spod szachu (pusto, gdy nie ma szachu)
+enum class GenType { ALL, CAPTURES, QUIETS, EVASIONS };
+
+// Dane do szybkiego givesCheck, liczone raz na pozycję (strona na ruchu szachuje króla przeciwnika):
+// checkSquares[pt] - pola, z których bierka typu pt atakuje króla przeciwnika;
+// discoverers - nasze bierki, których zejście z linii odsłania szach od naszej figury dalekosiężnej
+struct CheckInfo {
+    int kingSq{NO_SQUARE};
+    Bitboard checkSquares[6]{};
+    Bitboard discoverers{0};
+
+    CheckInfo() = default;
+    explicit CheckInfo(const Position& pos);
+};
 
 class MoveGenerator {
 private:
-    static bool wouldKingBeInCheck(const char board[8][8], const Move& move, char activeColor);
-    
-    static void generatePawnMoves(const char board[8][8], int row, int col, char activeColor, 
-                                 const std::string& enPassant, std::vector<Move>& moves);
-    static void generateKnightMoves(const char board[8][8], int row, int col, char activeColor, std::vector<Move>& moves);
-    static void generateBishopMoves(const char board[8][8], int row, int col, char activeColor, std::vector<Move>& moves);
-    static void generateRookMoves(const char board[8][8], int row, int col, char activeColor, std::vector<Move>& moves);
-    static void generateQueenMoves(const char board[8][8], int row, int col, char activeColor, std::vector<Move>& moves);
-    static void generateKingMoves(const char board[8][8], int row, int col, char activeColor, 
-                                 const std::string& castling, std::vector<Move>& moves);
+    // Strona do ruchu (Us) jest parametrem szablonu: kierunek pionów, linie promocji,
+    // pola roszady i kolor przeciwnika to stałe, więc każda strona ma własny kod bez
+    // rozgałęzień na kolor. Publiczne funkcje wybierają specjalizację jeden raz na wejściu.
+
+    // Ruchy pionów (bez EP) z podanego zbioru pionów na pola z maski targets
+    template <Color Us>
+    static void generatePawnMoves(const Position& pos, Bitboard pawns, Bitboard targets,
+                                  GenType type, MoveList& moves);
+    // Bicie w przelocie; legal = sprawdź odsłonięcie króla (także po linii poziomej)
+    template <Color Us>
+    static void generateEnPassant(const Position& pos, Bitboard targets, bool legal, MoveList& moves);
+    // Skoczki, gońce, wieże i hetmany z podanego zbioru na pola z maski targets
+    static void generatePieceMoves(const Position& pos, PieceType pt, Bitboard pieces, Bitboard targets, MoveList& moves);
+    // Król i roszady. danger - pola atakowane przez przeciwnika (Attack::attackedBy, król zdjęty
+    // z planszy); roszada zawsze je omija, zwykłe ruchy króla tylko gdy legal
+    template <Color Us>
+    static void generateKingMoves(const Position& pos, GenType type, Bitboard danger, bool legal, MoveList& moves);
+    // Mapa ataków przeciwnika potrzebna tylko roszadzie (0, gdy Us nie ma już praw roszady)
+    template <Color Us> static Bitboard castlingDanger(const Position& pos);
+
+    // Dane legalnej generacji liczone raz na pozycję - wspólne dla generateLegal i anyLegalMove
+    struct LegalContext {
+        Bitboard danger;      // pola atakowane przez przeciwnika (król zdjęty z planszy)
+        Bitboard checkers;    // bierki szachujące naszego króla
+        Bitboard checkMask;   // przy szachu: szachujący i pola zasłony, inaczej wszystkie pola
+        Bitboard pinned;      // nasze bierki związane z królem
+    };
+    template <Color Us> static LegalContext legalContext(const Position& pos, int kingSq);
+
+    template <Color Us> static void generateAll(const Position& pos, MoveList& moves);
+    template <Color Us> static void generateLegal(const Position& pos, MoveList& moves, GenType type);
+    template <Color Us> static void generatePieceFrom(const Position& pos, int from, MoveList& moves);
+    template <Color Us> static bool inCheck(const Position& pos);
+    // Czy jest choć jeden legalny ruch - bez listy ruchów, wyjście przy pierwszym znalezionym
+    template <Color Us> static bool anyLegalMove(const Position& pos);
 
 public:
-    static std::vector<Move> generateAllMoves(const char board[8][8], char activeColor, 
-                                            const std::string& castling, const std::string& enPassant);
-    static std::vector<Move> generateLegalMoves(const char board[8][8], char activeColor, 
-                                              const std::string& castling, const std::string& enPassant);
-    static bool hasLegalMoves(const char board[8][8], char activeColor, 
-                             const std::string& castling, const std::string& enPassant);
+    // Wersje bitboardowe - strona, roszady i EP brane ze stanu pozycji.
+    // generateAllMoves - pseudo-legalne; generateLegalMoves - tylko legalne (szachujący,
+    // związane bierki i maska obrony przed szachem liczone raz na pozycję).
+    // Wynik trafia do MoveList (bez alokacji) - tego używa wyszukiwanie i perft.
+    static void generateAllMoves(const Position& pos, MoveList& moves);
+    static void generateLegalMoves(const Position& pos, MoveList& moves, GenType type = GenType::ALL);
+    // Węższe zbiory legalnych ruchów (quiescence, MovePicker, analiza taktyczna)
+    static void generateCaptures(const Position& pos, MoveList& moves);   // bicia (z EP) i wszystkie promocje
+    static void generateQuiets(const Position& pos, MoveList& moves);     // pozostałe, z roszadą
+    static void generateEvasions(const Position& pos, MoveList& moves);   // tylko gdy król jest szachowany
+    static std::vector<Move> generateAllMoves(const Position& pos);   // cienkie opakowania
+    static std::vector<Move> generateLegalMoves(const Position& pos);
+    static bool hasLegalMoves(const Position& pos);   // leniwie: król, potem bierka po bierce
+    static bool isInCheck(const Position& pos);
+
+    // Walidacja ruchu spoza generatora (np. z TT, killer): czy to ruch tej bierki
+    // zgodny z zasadami (pseudo-legalny) i czy nie zostawia króla pod szachem
+    static bool isPseudoLegal(const Position& pos, const Move& move);
+    static bool isLegal(const Position& pos, const Move& move);   // zakłada isPseudoLegal
+
+    // Czy legalny ruch daje szach - bez makeMove/unmakeMove (szach bezpośredni, odsłonięty,
+    // po promocji, po biciu w przelocie i po roszadzie)
+    static bool givesCheck(const Position& pos, const Move& move, const CheckInfo& ci);
+    static bool givesCheck(const Position& pos, const Move& move);   // liczy CheckInfo sam
+
+    // Wersje na tablicy 8x8 - budują Position i delegują
+    static std::vector<Move> generateAllMoves(const char board[8][8], char activeColor,
+                                            const PositionState& state);
+    static std::vector<Move> generateLegalMoves(const char board[8][8], char activeColor,
+                                              const PositionState& state);
+    static bool hasLegalMoves(const char board[8][8], char activeColor, const PositionState& state);
     static bool isInCheck(const char board[8][8], char activeColor);
-};
\ No newline at end of file
+};
@@ -2,6 +2,7 @@
 #pragma once
 #include <string>
 #include <cctype>
+#include "chess/board/PositionState.h"
 
 namespace notation {
 
@@ -21,6 +22,37 @@ namespace notation {
         return true;
     }
 
+    // indeks pola (row * 8 + col) <-> "e3"; NO_SQUARE <-> "-"
+    inline std::string squareToAlg(int sq) {
+        return sq == NO_SQUARE ? std::string("-") : coordToAlg(sq >> 3, sq & 7);
+    }
+
+    inline int algToSquare(const std::string& s) {
+        int row, col;
+        return algToCoord(s, row, col) ? row * 8 + col : NO_SQUARE;
+    }
+
+    // "KQkq" <-> maska CASTLE_*; brak praw <-> "-"
+    inline uint8_t castlingFromString(const std::string& s) {
+        uint8_t mask = 0;
+        for (char c : s) {
+            if (c == 'K') mask |= CASTLE_WK;
+            if (c == 'Q') mask |= CASTLE_WQ;
+            if (c == 'k') mask |= CASTLE_BK;
+            if (c == 'q') mask |= CASTLE_BQ;
+        }
+        return mask;
+    }
+
+    inline std::string castlingToString(uint8_t mask) {
+        std::string s;
+        if (mask & CASTLE_WK) s += 'K';
+        if (mask & CASTLE_WQ) s += 'Q';
+        if (mask & CASTLE_BK) s += 'k';
+        if (mask & CASTLE_BQ) s += 'q';
+        return s.empty() ? "-" : s;
+    }
+
     // (opcjonalnie, jeśli gdzieś użyjesz)
     inline int fileToCol(char file) { return file - 'a'; }
     inline int rankToRow(char rank) { return '8' - rank; }
@@ -1,86 +1,116 @@
 #include "chess/ai/ChessAI.h"
 #include "chess/rules/MoveGenerator.h"
 #include "chess/ai/Evaluator.h"
+#include "chess/model/PackedMove.h"
+#include "chess/ai/MovePicker.h"
+#include "chess/ai/See.h"
 #include <algorithm>
+#include <cctype>
 #include <iostream>
-#include <limits>
+#include <thread>
 
-ChessAI::ChessAI() : nodesVisited(0) {
-    ZobristHash::initialize();
-}
+ChessAI::ChessAI()
+    : transpositionTable(std::make_shared<TranspositionTable>()), nodesVisited(0),
+      evalCache(std::make_shared<EvalCache>()), stop(&stopSearch) {}
+
+ChessAI::ChessAI(std::shared_ptr<TranspositionTable> table, std::shared_ptr<EvalCache> cache,
+                 const std::atomic<bool>* stop)
+    : transpositionTable(std::move(table)), nodesVisited(0), evalCache(std::move(cache)),
+      mainThread(false), stop(stop) {}
 
-SearchResult ChessAI::findBestMove(const char board[8][8], char activeColor, 
-                                  const std::string& castling, const std::string& enPassant,
+SearchResult ChessAI::findBestMove(const char board[8][8], char activeColor, const PositionState& state,
                                   int maxDepth, int maxTimeMs) {
     resetNodesCount();
+    transpositionTable->newSearch();
     searchStartTime = std::chrono::steady_clock::now();
+    stopSearch.store(false, std::memory_order_relaxed);
+    for (auto& k : killers) k[0] = k[1] = PackedMove();
+    
+    // Jedna pozycja na wątek - ruchy wykonujemy i cofamy w miejscu
+    Position pos(board);
+    pos.setState(toColor(activeColor), state);
+    
+    // Pomocnicy Lazy SMP szukają do końca wyszukiwania głównego wątku; ich wyniki trafiają
+    // do wspólnej TT i przyspieszają główny wątek, same ruchy pomocników pomijamy
+    std::vector<std::unique_ptr<ChessAI>> helpers;
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threadCount; i++) {
+        helpers.emplace_back(new ChessAI(transpositionTable, evalCache, &stopSearch));
+        ChessAI* helper = helpers.back().get();
+        helper->searchStartTime = searchStartTime;
+        workers.emplace_back([helper, pos, maxDepth, maxTimeMs]() mutable {
+            helper->iterativeDeepening(pos, maxDepth, maxTimeMs);
+        });
+    }
     
-    return iterativeDeepening(board, activeColor, castling, enPassant, maxDepth, maxTimeMs);
+    SearchResult result = iterativeDeepening(pos, maxDepth, maxTimeMs);
+    
+    stopSearch.store(true, std::memory_order_relaxed);
+    for (auto& w : workers) w.join();
+    pawnProbes = pawnTable.getProbes();
+    pawnHits = pawnTable.getHits();
+    for (auto& h : helpers) {
+        nodesVisited += h->nodesVisited;
+        ttProbes += h->ttProbes;
+        ttHits += h->ttHits;
+        pawnProbes += h->pawnTable.getProbes();
+        pawnHits += h->pawnTable.getHits();
+        evalProbes += h->evalProbes;
+        evalHits += h->evalHits;
+    }
+    result.nodesVisited = nodesVisited;
+    return result;
 }
 
-SearchResult ChessAI::iterativeDeepening(const char board[8][8], char activeColor, 
-                                        const std::string& castling, const std::string& enPassant,
-                                        int maxDepth, int maxTimeMs) {
+SearchResult ChessAI::iterativeDeepening(Position& pos, int maxDepth, int maxTimeMs) {
     SearchResult result;
     result.bestMove = {0, 0, 0, 0, '?', 0}; // Domyślny ruch
+    aborted = false;
     
-    // Generuj wszystkie legalne ruchy
-    std::vector<Move> moves = MoveGenerator::generateLegalMoves(board, activeColor, castling, enPassant);
+    // Generuj wszystkie legalne ruchy (lista na stosie, bez alokacji)
+    MoveList moves;
+    MoveGenerator::generateLegalMoves(pos, moves);
   
     // Sprawdź liczbę ruchów
     if (moves.empty()) {
-        std::cout << "UWAGA: AI nie znalazł żadnych legalnych ruchów!" << std::endl;
+        if (mainThread) std::cout << "UWAGA: AI nie znalazł żadnych legalnych ruchów!" << std::endl;
         return result;
     }
     
     // Sortuj ruchy dla lepszego Alfa-Beta Pruning
-    sortMoves(moves, board, activeColor, castling, enPassant);
+    sortMoves(moves, pos);
     
     // Iterative Deepening - zaczynamy od głębokości 1
     for (int depth = 1; depth <= maxDepth; depth++) {
         if (isTimeUp()) break;
+        rootDepth = depth;
+        
+        // Najlepszy ruch poprzedniej iteracji (lub innego wątku) z TT idzie na początek;
+        // kolejność pozostałych bez zmian
+        PackedMove rootTTMove = transpositionTable->probeMove(pos.hash);
+        for (int i = 1; i < moves.size(); i++) {
+            if (PackedMove::fromMove(moves[i]) == rootTTMove) {
+                std::rotate(moves.begin(), moves.begin() + i, moves.begin() + i + 1);
+                break;
+            }
+        }
         
         SearchResult currentResult;
         currentResult.depth = depth;
         currentResult.bestMove = moves[0]; // Domyślnie pierwszy ruch
         
-        int bestScore = std::numeric_limits<int>::min();
-        int alpha = std::numeric_limits<int>::min();
-        int beta = std::numeric_limits<int>::max();
+        int bestScore = -INF;
+        int alpha = -INF;
+        int beta = INF;
         
         // Wyszukaj najlepszy ruch dla aktualnej głębokości
         for (const Move& move : moves) {
-            // Symuluj ruch
-            char tempBoard[8][8];
-            std::string tempCastling = castling;
-            std::string tempEnPassant = enPassant;
-            char tempActiveColor = activeColor;
-            
-            // Skopiuj planszę
-            for (int i = 0; i < 8; i++) {
-                for (int j = 0; j < 8; j++) {
-                    tempBoard[i][j] = board[i][j];
-                }
-            }
-            
-            // Wykonaj ruch (uproszczona wersja)
-            tempBoard[move.toRow][move.toCol] = tempBoard[move.fromRow][move.fromCol];
-            tempBoard[move.fromRow][move.fromCol] = 0;
-            
-            // Obsługa promocji piona
-            if (move.promotion) {
-                tempBoard[move.toRow][move.toCol] = move.promotion;
-            }
-
-            // Zmień stronę do ruchu
-            tempActiveColor = (tempActiveColor == 'w') ? 'b' : 'w';
-            
-            // Oblicz nowy hash
-            uint64_t newHash = ZobristHash::calculateHash(tempBoard, tempActiveColor, tempCastling, tempEnPassant);
-            
-            // Wykonaj wyszukiwanie NegaMax
-            int score = -negamax(tempBoard, tempActiveColor, tempCastling, tempEnPassant, 
-                                depth - 1, -beta, -alpha, newHash);
+            // Wykonaj ruch w miejscu, przeszukaj i cofnij
+            pos.makeMove(move);
+            transpositionTable->prefetch(pos.hash);
+            int score = -negamax(pos, depth - 1, -beta, -alpha);
+            pos.unmakeMove(move);
+            if (aborted) break;
             
             if (score > bestScore) {
                 bestScore = score;
@@ -96,38 +126,43 @@ SearchResult ChessAI::iterativeDeepening(const char board[8][8], char activeColo
         currentResult.timeSpent = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - searchStartTime);
         
-        // Jeśli czas się skończył, przerwij
-        if (isTimeUp()) break;
+        // Przerwana iteracja jest niepełna - zostaje wynik poprzedniej, nic nie zapisujemy
+        if (aborted) break;
         
-        // Zaktualizuj wynik
+        // Zaktualizuj wynik; ruch korzenia w TT porządkuje następną iterację
         result = currentResult;
+        transpositionTable->store(pos.hash, depth, scoreToTT(bestScore, pos.ply()), NodeType::EXACT,
+                                  PackedMove::fromMove(result.bestMove));
         
         // Jeśli znaleźliśmy mata, nie ma potrzeby szukać głębiej
-        if (std::abs(result.score) > 10000) break;
+        if (std::abs(result.score) > MATE_SCORE - MAX_DEPTH) break;
         
         // Sprawdź czy AI znalazło ruch
         if (result.bestMove.fromRow == 0 && result.bestMove.fromCol == 0 && 
             result.bestMove.toRow == 0 && result.bestMove.toCol == 0) {
-            std::cout << "UWAGA: AI nie znalazło żadnego ruchu!" << std::endl;
+            if (mainThread) std::cout << "UWAGA: AI nie znalazło żadnego ruchu!" << std::endl;
             break;
         }
 
-        std::cout << "Głębokość " << depth << ": " << result.score
+        if (mainThread && verbose) std::cout << "Głębokość " << depth << ": " << result.score
                   << " (węzły: " << result.nodesVisited << ")" << std::endl;
     }
     
     return result;
 }
 
-int ChessAI::negamax(const char board[8][8], char activeColor, const std::string& castling, 
-                     const std::string& enPassant, int depth, int alpha, int beta, 
-                     uint64_t zobristHash) {
+int ChessAI::negamax(Position& pos, int depth, int alpha, int beta) {
     nodesVisited++;
+    uint64_t zobristHash = pos.hash;
     
     // Sprawdź tablicę transpozycji
     int ttScore;
     NodeType ttNodeType;
-    if (transpositionTable.probe(zobristHash, depth, ttScore, ttNodeType)) {
+    PackedMove ttMove;
+    ttProbes++;
+    if (transpositionTable->probe(zobristHash, depth, ttScore, ttNodeType, ttMove)) {
+        ttHits++;
+        ttScore = scoreFromTT(ttScore, pos.ply());
         if (ttNodeType == NodeType::EXACT) {
             return ttScore;
         } else if (ttNodeType == NodeType::ALPHA && ttScore <= alpha) {
@@ -137,85 +172,60 @@ int ChessAI::negamax(const char board[8][8], char activeColor, const std::string
         }
     }
     
-    // Sprawdź czy czas się skończył
-    if (isTimeUp()) {
+    // Sprawdź czy czas się skończył; zwracana wartość i tak zostanie pominięta
+    if (checkAbort()) {
         return 0;
     }
     
-    // Sprawdź czy osiągnęliśmy maksymalną głębokość lub koniec gry
+    // Po osiągnięciu głębokości dokończ wymiany; wynik zależy od okna, więc zapisujemy ograniczenie
     if (depth == 0) {
-        int score = Evaluator::evaluatePosition(board, activeColor);
-        transpositionTable.store(zobristHash, depth, score, NodeType::EXACT);
+        int score = quiescence(pos, alpha, beta);
+        if (aborted) return 0;
+        NodeType type = score <= alpha ? NodeType::ALPHA : score >= beta ? NodeType::BETA : NodeType::EXACT;
+        transpositionTable->store(zobristHash, depth, scoreToTT(score, pos.ply()), type);
         return score;
     }
     
-    // Sprawdź stan gry
-    bool hasLegalMoves = MoveGenerator::hasLegalMoves(board, activeColor, castling, enPassant);
-    bool isInCheck = MoveGenerator::isInCheck(board, activeColor);
-    
-    if (!hasLegalMoves) {
-        if (isInCheck) {
-            // Mat - bardzo duża wartość
-            int score = (activeColor == 'w') ? -10000 : 10000;
-            transpositionTable.store(zobristHash, depth, score, NodeType::EXACT);
-            return score;
-        } else {
-            // Pat - remis
-            transpositionTable.store(zobristHash, depth, 0, NodeType::EXACT);
-            return 0;
-        }
-    }
-    
-    // Generuj wszystkie legalne ruchy
-    std::vector<Move> moves = MoveGenerator::generateLegalMoves(board, activeColor, castling, enPassant);
-    
-    // Sortuj ruchy dla lepszego Alfa-Beta Pruning
-    sortMoves(moves, board, activeColor, castling, enPassant);
+    // Ruchy po kolei z MovePicker - kolejne etapy generowane dopiero, gdy są potrzebne
+    PackedMove* nodeKillers = killers[pos.ply()];
+    MovePicker picker(pos, ttMove, nodeKillers);
     
-    int bestScore = std::numeric_limits<int>::min();
+    int bestScore = -INF;
+    PackedMove bestMove;
     NodeType bestNodeType = NodeType::ALPHA;
     int originalAlpha = alpha;
+    int moveCount = 0;
+    Move move;
+    CheckInfo checkInfo(pos);
     
-    for (const Move& move : moves) {
-        // Symuluj ruch
-        char tempBoard[8][8];
-        std::string tempCastling = castling;
-        std::string tempEnPassant = enPassant;
-        char tempActiveColor = activeColor;
+    while (picker.next(move)) {
+        moveCount++;
         
-        // Skopiuj planszę
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                tempBoard[i][j] = board[i][j];
-            }
-        }
+        // Przedłużenie za szach: ruch szachujący przeszukujemy o półruch głębiej
+        int extension = (pos.ply() < 2 * rootDepth && MoveGenerator::givesCheck(pos, move, checkInfo)) ? 1 : 0;
         
-        // Wykonaj ruch (uproszczona wersja)
-        tempBoard[move.toRow][move.toCol] = tempBoard[move.fromRow][move.fromCol];
-        tempBoard[move.fromRow][move.fromCol] = 0;
-        
-        // Obsługa promocji piona
-        if (move.promotion) {
-            tempBoard[move.toRow][move.toCol] = move.promotion;
-        }
-      
-        // Zmień stronę do ruchu
-        tempActiveColor = (tempActiveColor == 'w') ? 'b' : 'w';
-        
-        // Oblicz nowy hash
-        uint64_t newHash = ZobristHash::calculateHash(tempBoard, tempActiveColor, tempCastling, tempEnPassant);
-        
-        // Rekurencyjne wywołanie NegaMax
-        int score = -negamax(tempBoard, tempActiveColor, tempCastling, tempEnPassant, 
-                            depth - 1, -beta, -alpha, newHash);
+        // Wykonaj ruch w miejscu, przeszukaj i cofnij; kubełek TT dziecka ładuje się w tle
+        pos.makeMove(move);
+        transpositionTable->prefetch(pos.hash);
+        int score = -negamax(pos, depth - 1 + extension, -beta, -alpha);
+        pos.unmakeMove(move);
+        if (aborted) return 0;   // ocena dziecka niepełna - bez killerów i zapisu do TT
         
         if (score > bestScore) {
             bestScore = score;
+            bestMove = PackedMove::fromMove(move);
         }
         
         // Alfa-Beta Pruning
         if (score >= beta) {
-            transpositionTable.store(zobristHash, depth, score, NodeType::BETA);
+            // Cichy ruch z odcięciem zapamiętujemy jako killer dla tego poziomu
+            PackedMove packed = bestMove;
+            if (!move.capturedPiece && packed.type() != PackedMove::PROMOTION &&
+                packed.type() != PackedMove::EN_PASSANT && packed != nodeKillers[0]) {
+                nodeKillers[1] = nodeKillers[0];
+                nodeKillers[0] = packed;
+            }
+            transpositionTable->store(zobristHash, depth, scoreToTT(score, pos.ply()), NodeType::BETA, packed);
             return score;
         }
         
@@ -225,6 +235,13 @@ int ChessAI::negamax(const char board[8][8], char activeColor, const std::string
         }
     }
     
+    // Brak ruchów: mat (z perspektywy strony na ruchu - przegrana, bliższy gorszy) albo pat
+    if (moveCount == 0) {
+        int score = MoveGenerator::isInCheck(pos) ? -MATE_SCORE + pos.ply() : 0;
+        transpositionTable->store(zobristHash, depth, scoreToTT(score, pos.ply()), NodeType::EXACT);
+        return score;
+    }
+    
     // Określ typ węzła dla tablicy transpozycji
     if (bestScore <= originalAlpha) {
         bestNodeType = NodeType::ALPHA;
@@ -234,62 +251,126 @@ int ChessAI::negamax(const char board[8][8], char activeColor, const std::string
         bestNodeType = NodeType::EXACT;
     }
     
-    // Zapisz wynik w tablicy transpozycji
-    transpositionTable.store(zobristHash, depth, bestScore, bestNodeType);
+    // Zapisz wynik w tablicy transpozycji; przy fail-low ruchy są nierozróżnialne,
+    // więc zostawiamy ruch zapisany wcześniej
+    transpositionTable->store(zobristHash, depth, scoreToTT(bestScore, pos.ply()), bestNodeType,
+                              bestNodeType == NodeType::EXACT ? bestMove : PackedMove());
     
     return bestScore;
 }
 
+int ChessAI::quiescence(Position& pos, int alpha, int beta) {
+    nodesVisited++;
+    if (checkAbort()) {
+        return 0;
+    }
+    
+    // Pod szachem nie ma "stania w miejscu" - szukamy wszystkich ucieczek
+    bool inCheck = MoveGenerator::isInCheck(pos);
+    int bestScore = -INF;
+    if (!inCheck) {
+        bestScore = evaluate(pos);
+        if (bestScore >= beta) return bestScore;
+        alpha = std::max(alpha, bestScore);
+    }
+    if (pos.ply() >= Position::MAX_PLY - 1) {
+        return inCheck ? 0 : bestScore;
+    }
+    
+    MovePicker picker = inCheck ? MovePicker(pos, PackedMove(), killers[pos.ply()]) : MovePicker(pos);
+    int moveCount = 0;
+    Move move;
+    
+    while (picker.next(move)) {
+        moveCount++;
+        
+        pos.makeMove(move);
+        int score = -quiescence(pos, -beta, -alpha);
+        pos.unmakeMove(move);
+        if (aborted) return 0;
+        
+        if (score > bestScore) {
+            bestScore = score;
+        }
+        if (score >= beta) {
+            return score;
+        }
+        alpha = std::max(alpha, score);
+    }
+    
+    if (inCheck && moveCount == 0) {
+        return -MATE_SCORE + pos.ply();
+    }
+    return bestScore;
+}
+
+int ChessAI::evaluate(const Position& pos) {
+    // Ta sama pozycja osiągnięta inną drogą (lub przez inny wątek) - ocena już policzona
+    int score;
+    evalProbes++;
+    if (evalCache->probe(pos.hash, score)) {
+        evalHits++;
+        return score;
+    }
+    score = Evaluator::evaluatePosition(pos, toColorChar(pos.sideToMove), &pawnTable);
+    evalCache->store(pos.hash, score);
+    return score;
+}
+
+int ChessAI::scoreToTT(int score, int ply) {
+    if (score > MATE_BOUND) return score + ply;
+    if (score < -MATE_BOUND) return score - ply;
+    return score;
+}
+
+int ChessAI::scoreFromTT(int score, int ply) {
+    if (score > MATE_BOUND) return score - ply;
+    if (score < -MATE_BOUND) return score + ply;
+    return score;
+}
+
 bool ChessAI::isTimeUp() const {
+    if (stop->load(std::memory_order_relaxed)) return true;
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - searchStartTime);
     return elapsed.count() >= MAX_TIME_MS;
 }
 
-void ChessAI::sortMoves(std::vector<Move>& moves, const char board[8][8], 
-                        char activeColor, const std::string& castling, 
-                        const std::string& enPassant) {
+void ChessAI::sortMoves(MoveList& moves, const Position& pos) {
     // Sortuj ruchy według priorytetu:
-    // 1. Bicia (z wartością bicia)
+    // 1. Bicia wygrywające lub wyrównane (wg SEE - bilansu całej wymiany)
     // 2. Ruchy promocji
     // 3. Ruchy do centrum
-    // 4. Pozostałe ruchy
-    
-    std::sort(moves.begin(), moves.end(), [&](const Move& a, const Move& b) {
-        int scoreA = 0, scoreB = 0;
+    // 4. Pozostałe ruchy, na końcu bicia przegrywające materiał
+    auto scoreMove = [&pos](const Move& m) {
+        int score = 0;
         
-        // Bicia
-        if (a.capturedPiece) {
-            scoreA += 1000 + Evaluator::PAWN_VALUE; // Podstawowy bonus za bicie
-            switch (std::toupper(a.capturedPiece)) {
-                case 'P': scoreA += Evaluator::PAWN_VALUE; break;
-                case 'N': scoreA += Evaluator::KNIGHT_VALUE; break;
-                case 'B': scoreA += Evaluator::BISHOP_VALUE; break;
-                case 'R': scoreA += Evaluator::ROOK_VALUE; break;
-                case 'Q': scoreA += Evaluator::QUEEN_VALUE; break;
-            }
-        }
-        if (b.capturedPiece) {
-            scoreB += 1000 + Evaluator::PAWN_VALUE;
-            switch (std::toupper(b.capturedPiece)) {
-                case 'P': scoreB += Evaluator::PAWN_VALUE; break;
-                case 'N': scoreB += Evaluator::KNIGHT_VALUE; break;
-                case 'B': scoreB += Evaluator::BISHOP_VALUE; break;
-                case 'R': scoreB += Evaluator::ROOK_VALUE; break;
-                case 'Q': scoreB += Evaluator::QUEEN_VALUE; break;
-            }
+        // Bicia (także w przelocie)
+        if (m.capturedPiece || (std::toupper(m.movedPiece) == 'P' && m.fromCol != m.toCol)) {
+            int see = See::evaluate(pos, m);
+            score += see >= 0 ? 1000 + Evaluator::PAWN_VALUE + see : see;
         }
         
         // Promocje
-        if (a.promotion) scoreA += 500;
-        if (b.promotion) scoreB += 500;
+        if (m.promotion) score += 500;
         
         // Ruchy do centrum
-        int centerDistanceA = std::abs(a.toRow - 3.5) + std::abs(a.toCol - 3.5);
-        int centerDistanceB = std::abs(b.toRow - 3.5) + std::abs(b.toCol - 3.5);
-        scoreA += (7 - centerDistanceA) * 10;
-        scoreB += (7 - centerDistanceB) * 10;
+        int centerDistance = std::abs(m.toRow - 3.5) + std::abs(m.toCol - 3.5);
+        score += (7 - centerDistance) * 10;
         
-        return scoreA > scoreB;
-    });
+        return static_cast<int16_t>(score);
+    };
+    
+    // Ocena liczona raz na ruch; sortujemy 4-bajtowe ScoredMove zamiast pełnych Move
+    ScoredMove scored[MoveList::MAX_MOVES];
+    int n = moves.size();
+    for (int i = 0; i < n; i++) {
+        scored[i] = {PackedMove::fromMove(moves[i]), scoreMove(moves[i])};
+    }
+    std::sort(scored, scored + n, [](const ScoredMove& a, const ScoredMove& b) { return b < a; });
+    
+    // Bierki odtwarzamy z pozycji sprzed ruchu
+    for (int i = 0; i < n; i++) {
+        moves[i] = scored[i].move.toMove(pos);
+    }
 }
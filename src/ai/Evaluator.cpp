@@ -1,107 +1,139 @@
 #include "chess/ai/Evaluator.h"
+#include "chess/rules/Attack.h"
 #include <cctype>
 #include <cmath>
 
 namespace Evaluator {
 
-int evaluatePosition(const char board[8][8], char activeColor) {
-    int score = 0;
-    
-    // Ocena materialna
-    for (int row = 0; row < 8; row++) {
+using namespace Bitboards;
+
+namespace {
+    // Pola e4, e5, d4, d5
+    constexpr Bitboard CENTER = squareBB(square(3, 3)) | squareBB(square(3, 4)) |
+                                squareBB(square(4, 3)) | squareBB(square(4, 4));
+
+    constexpr Bitboard adjacentFiles(int col) {
+        return (col > 0 ? fileBB(col - 1) : 0) | (col < 7 ? fileBB(col + 1) : 0);
+    }
+
+    // Rzędy przed pionem danej strony (białe idą w stronę row 0)
+    constexpr Bitboard rowsAhead(Color c, int row) {
+        if (c == WHITE) return squareBB(row * 8) - 1;
+        return row == 7 ? 0 : ~(squareBB((row + 1) * 8) - 1);
+    }
+
+    // Pion jest wolny, gdy przed nim na jego i sąsiednich liniach nie ma pionów przeciwnika
+    constexpr Bitboard passedMask(Color c, int sq) {
+        return (fileBB(colOf(sq)) | adjacentFiles(colOf(sq))) & rowsAhead(c, rowOf(sq));
+    }
+
+    int pawnTerms(Bitboard ours, Bitboard theirs, Color c) {
+        int score = 0;
         for (int col = 0; col < 8; col++) {
-            char piece = board[row][col];
-            if (!piece) continue;
-            
-            bool isWhite = std::isupper(piece);
-            int multiplier = isWhite ? 1 : -1;
-            
-            switch (std::toupper(piece)) {
-                case 'P': score += PAWN_VALUE * multiplier; break;
-                case 'N': score += KNIGHT_VALUE * multiplier; break;
-                case 'B': score += BISHOP_VALUE * multiplier; break;
-                case 'R': score += ROOK_VALUE * multiplier; break;
-                case 'Q': score += QUEEN_VALUE * multiplier; break;
-                case 'K': score += KING_VALUE * multiplier; break;
+            int count = popCount(ours & fileBB(col));
+            if (count > 1) score -= PAWN_STRUCTURE_BONUS * (count - 1);
+            if (count && !(ours & adjacentFiles(col))) score -= ISOLATED_PAWN_PENALTY * count;
+        }
+        for (Bitboard b = ours; b; ) {
+            int sq = popLsb(b);
+            if (!(theirs & passedMask(c, sq))) {
+                int advanced = c == WHITE ? 6 - rowOf(sq) : rowOf(sq) - 1;
+                score += PASSED_PAWN_BONUS[advanced];
             }
         }
+        return score;
+    }
+}
+
+int evaluatePosition(const Position& pos, char activeColor, PawnHashTable* pawnTable) {
+    int score = 0;
+    
+    // Ocena materialna
+    for (int pt = PAWN; pt <= KING; pt++) {
+        score += PIECE_VALUES[pt] * (popCount(pos.piecesOf(WHITE, PieceType(pt))) -
+                                     popCount(pos.piecesOf(BLACK, PieceType(pt))));
     }
     
     // Bonusy pozycyjne
-    score += evaluatePawnStructure(board);
-    score += evaluateCenterControl(board);
-    score += evaluateKingSafety(board);
+    score += evaluatePawns(pos, pawnTable);
+    score += evaluateCenterControl(pos);
+    score += evaluateKingSafety(pos);
     
     // Zwróć ocenę z perspektywy strony do ruchu
     return (activeColor == 'w') ? score : -score;
 }
 
-int evaluatePawnStructure(const char board[8][8]) {
-    int score = 0;
+int evaluatePosition(const char board[8][8], char activeColor) {
+    return evaluatePosition(Position(board), activeColor);
+}
+
+int evaluatePawnStructure(const Position& pos) {
+    // Kary za podwójne i izolowane piony, premia za wolne (rosnąca z postępem)
+    Bitboard whitePawns = pos.piecesOf(WHITE, PAWN);
+    Bitboard blackPawns = pos.piecesOf(BLACK, PAWN);
+    return pawnTerms(whitePawns, blackPawns, WHITE) - pawnTerms(blackPawns, whitePawns, BLACK);
+}
+
+int evaluatePawnShield(const Position& pos, Color color) {
+    int king = pos.kingSquare(color);
+    if (king == NO_SQUARE) return 0;
     
-    // Bonus za podwójne piony
-    for (int col = 0; col < 8; col++) {
-        int whitePawns = 0, blackPawns = 0;
-        for (int row = 0; row < 8; row++) {
-            if (board[row][col] == 'P') whitePawns++;
-            if (board[row][col] == 'p') blackPawns++;
-        }
-        
-        if (whitePawns > 1) score -= PAWN_STRUCTURE_BONUS * (whitePawns - 1);
-        if (blackPawns > 1) score += PAWN_STRUCTURE_BONUS * (blackPawns - 1);
+    // Własne piony na dwóch rzędach przed królem, na jego i sąsiednich liniach
+    Bitboard rows = 0;
+    for (int d = 1; d <= 2; d++) {
+        int row = rowOf(king) + (color == WHITE ? -d : d);
+        if (row >= 0 && row < 8) rows |= rowBB(row);
     }
-    
-    return score;
+    Bitboard zone = rows & (fileBB(colOf(king)) | adjacentFiles(colOf(king)));
+    return PAWN_SHIELD_BONUS * popCount(pos.piecesOf(color, PAWN) & zone);
 }
 
-int evaluateCenterControl(const char board[8][8]) {
-    int score = 0;
+int evaluatePawns(const Position& pos, PawnHashTable* pawnTable) {
+    if (!pawnTable) {
+        return evaluatePawnStructure(pos) + evaluatePawnShield(pos, WHITE) - evaluatePawnShield(pos, BLACK);
+    }
     
-    // Bonus za kontrolę centrum (pola e4, e5, d4, d5)
-    const int centerSquares[4][2] = {{3,3}, {3,4}, {4,3}, {4,4}};
+    // Struktura zależy tylko od pionów; osłona także od pola króla - liczona ponownie,
+    // gdy król stoi gdzie indziej niż przy poprzednim liczeniu
+    bool found;
+    PawnHashTable::Entry& entry = pawnTable->probe(pos.pawnHash, found);
+    if (!found) entry.score = static_cast<int16_t>(evaluatePawnStructure(pos));
     
-    for (auto& square : centerSquares) {
-        int row = square[0], col = square[1];
-        char piece = board[row][col];
-        
-        if (piece) {
-            if (std::isupper(piece)) {
-                score += CENTER_CONTROL_BONUS;
-            } else {
-                score -= CENTER_CONTROL_BONUS;
-            }
+    for (Color c : {WHITE, BLACK}) {
+        int king = pos.kingSquare(c);
+        if (entry.kingSq[c] != king) {
+            entry.kingSq[c] = static_cast<int8_t>(king);
+            entry.shield[c] = static_cast<int16_t>(evaluatePawnShield(pos, c));
         }
     }
-    
-    return score;
+    return entry.score + entry.shield[WHITE] - entry.shield[BLACK];
 }
 
-int evaluateKingSafety(const char board[8][8]) {
+int evaluateCenterControl(const Position& pos) {
+    // Bonus za figury na polach centralnych
+    return CENTER_CONTROL_BONUS * (popCount(pos.colors[WHITE] & CENTER) -
+                                   popCount(pos.colors[BLACK] & CENTER));
+}
+
+int evaluateKingSafety(const Position& pos) {
     int score = 0;
     
-    // Znajdź pozycje królów
-    int whiteKingRow = -1, whiteKingCol = -1;
-    int blackKingRow = -1, blackKingCol = -1;
-    
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (board[row][col] == 'K') {
-                whiteKingRow = row; whiteKingCol = col;
-            } else if (board[row][col] == 'k') {
-                blackKingRow = row; blackKingCol = col;
-            }
-        }
-    }
-    
     // Bonus za bezpieczeństwo króla (im dalej od centrum, tym lepiej)
-    if (whiteKingRow != -1) {
-        int centerDistance = std::abs(whiteKingRow - 3.5) + std::abs(whiteKingCol - 3.5);
+    // i kara za pola wokół króla atakowane przez przeciwnika (mapa ataków z jednego przejścia)
+    int whiteKing = pos.kingSquare(WHITE);
+    if (whiteKing != NO_SQUARE) {
+        int centerDistance = std::abs(rowOf(whiteKing) - 3.5) + std::abs(colOf(whiteKing) - 3.5);
         score += KING_SAFETY_BONUS * (7 - centerDistance);
+        Bitboard attacked = Attack::attackedBy<BLACK>(pos, pos.occupied);
+        score -= KING_ZONE_ATTACK_PENALTY * popCount(AttackTables::kingAttacks(whiteKing) & attacked);
     }
     
-    if (blackKingRow != -1) {
-        int centerDistance = std::abs(blackKingRow - 3.5) + std::abs(blackKingCol - 3.5);
+    int blackKing = pos.kingSquare(BLACK);
+    if (blackKing != NO_SQUARE) {
+        int centerDistance = std::abs(rowOf(blackKing) - 3.5) + std::abs(colOf(blackKing) - 3.5);
         score -= KING_SAFETY_BONUS * (7 - centerDistance);
+        Bitboard attacked = Attack::attackedBy<WHITE>(pos, pos.occupied);
+        score += KING_ZONE_ATTACK_PENALTY * popCount(AttackTables::kingAttacks(blackKing) & attacked);
     }
     
     return score;
@@ -0,0 +1,147 @@
+#include "chess/ai/MovePicker.h"
+#include <cmath>
+#include <utility>
+#include "chess/ai/Evaluator.h"
+#include "chess/ai/See.h"
+#include "chess/rules/MoveGenerator.h"
+
+MovePicker::MovePicker(const Position& pos, PackedMove ttMove, const PackedMove killers[2])
+    : pos(pos), ttMove(ttMove), killers{killers[0], killers[1]} {}
+
+MovePicker::MovePicker(const Position& pos)
+    : pos(pos), stage(QS_GEN_CAPTURES) {}
+
+bool MovePicker::next(Move& move) {
+    switch (stage) {
+    case TT_MOVE:
+        stage = GEN_CAPTURES;
+        if (!ttMove.isNone() && isUsable(ttMove)) {
+            move = ttMove.toMove(pos);
+            return true;
+        }
+        [[fallthrough]];
+
+    case GEN_CAPTURES:
+        MoveGenerator::generateCaptures(pos, moves);
+        scoreCaptures();
+        current = 0;
+        stage = GOOD_CAPTURES;
+        [[fallthrough]];
+
+    case GOOD_CAPTURES:
+        while (current < moves.size()) {
+            const Move& m = pickBest();
+            PackedMove p = PackedMove::fromMove(m);
+            if (p == ttMove) continue;
+            // SEE dopiero przy wyborze - po odcięciu na pierwszym biciu reszty nie liczymy
+            if (See::evaluate(pos, m) < 0) {
+                badCaptures[badCount++] = p;
+                continue;
+            }
+            move = m;
+            return true;
+        }
+        stage = KILLERS;
+        [[fallthrough]];
+
+    case KILLERS:
+        // Killer to cichy ruch, który dał odcięcie w innym węźle na tym samym poziomie
+        while (killerIndex < 2) {
+            PackedMove k = killers[killerIndex++];
+            if (k.isNone() || k == ttMove || (killerIndex == 2 && k == killers[0])) continue;
+            if (k.type() != PackedMove::NORMAL && k.type() != PackedMove::CASTLING) continue;
+            if (pos.pieceAt(k.to()) || !isUsable(k)) continue;
+            move = k.toMove(pos);
+            return true;
+        }
+        stage = GEN_QUIETS;
+        [[fallthrough]];
+
+    case GEN_QUIETS:
+        MoveGenerator::generateQuiets(pos, moves);
+        scoreQuiets();
+        current = 0;
+        stage = QUIETS;
+        [[fallthrough]];
+
+    case QUIETS:
+        while (current < moves.size()) {
+            const Move& m = pickBest();
+            PackedMove p = PackedMove::fromMove(m);
+            if (p == ttMove || p == killers[0] || p == killers[1]) continue;
+            move = m;
+            return true;
+        }
+        stage = BAD_CAPTURES;
+        [[fallthrough]];
+
+    case BAD_CAPTURES:
+        if (badIndex < badCount) {
+            move = badCaptures[badIndex++].toMove(pos);
+            return true;
+        }
+        stage = DONE;
+        return false;
+
+    case QS_GEN_CAPTURES:
+        MoveGenerator::generateCaptures(pos, moves);
+        checkInfo = CheckInfo(pos);
+        scoreCaptures();
+        current = 0;
+        stage = QS_CAPTURES;
+        [[fallthrough]];
+
+    case QS_CAPTURES:
+        while (current < moves.size()) {
+            const Move& m = pickBest();
+            // Przegrywające bicia nie zmienią oceny - chyba że dają szach
+            if (See::evaluate(pos, m) < 0 && !MoveGenerator::givesCheck(pos, m, checkInfo)) continue;
+            move = m;
+            return true;
+        }
+        stage = DONE;
+        [[fallthrough]];
+
+    case DONE:
+        return false;
+    }
+    return false;
+}
+
+bool MovePicker::isUsable(PackedMove m) const {
+    Move move = m.toMove(pos);
+    return MoveGenerator::isPseudoLegal(pos, move) && MoveGenerator::isLegal(pos, move);
+}
+
+void MovePicker::scoreCaptures() {
+    // MVV-LVA: najcenniejsza ofiara, potem najtańszy napastnik; promocja dolicza zysk figury
+    for (int i = 0; i < moves.size(); i++) {
+        const Move& m = moves[i];
+        int victim = m.capturedPiece ? Evaluator::pieceValue(m.capturedPiece)
+                   : (m.fromCol != m.toCol ? Evaluator::PAWN_VALUE : 0);   // EP - cel pusty
+        int score = victim * 10 - Evaluator::pieceValue(m.movedPiece) / 10;
+        if (m.promotion) score += (Evaluator::pieceValue(m.promotion) - Evaluator::PAWN_VALUE) * 10;
+        scores[i] = score;
+    }
+}
+
+void MovePicker::scoreQuiets() {
+    // Ruchy do centrum przed pozostałymi (jak dotychczasowe sortMoves)
+    for (int i = 0; i < moves.size(); i++) {
+        const Move& m = moves[i];
+        int centerDistance = std::abs(m.toRow - 3.5) + std::abs(m.toCol - 3.5);
+        scores[i] = (7 - centerDistance) * 10;
+    }
+}
+
+const Move& MovePicker::pickBest() {
+    int best = current;
+    for (int i = current + 1; i < moves.size(); i++) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    if (best != current) {
+        std::swap(moves[best], moves[current]);
+        std::swap(scores[best], scores[current]);
+    }
+    return moves[current++];
+}
@@ -0,0 +1,65 @@
+#include "chess/ai/See.h"
+#include <algorithm>
+#include "chess/ai/Evaluator.h"
+#include "chess/rules/Attack.h"
+
+using namespace Bitboards;
+
+int See::evaluate(const Position& pos, const Move& move) {
+    int from = square(move.fromRow, move.fromCol);
+    int to   = square(move.toRow, move.toCol);
+    Color us = pos.sideToMove;
+
+    // gain[d] - bilans strony bijącej jako d-ta, gdy po jej biciu wymiana się kończy
+    int gain[32];
+    int depth = 0;
+    Bitboard occupied = pos.occupied ^ squareBB(from);
+
+    gain[0] = Evaluator::pieceValue(move.capturedPiece);
+    if (typeOf(pieceIndex(move.movedPiece)) == PAWN && move.fromCol != move.toCol && !move.capturedPiece) {
+        gain[0] = Evaluator::PAWN_VALUE;                                   // bicie w przelocie
+        occupied ^= squareBB(to + ((us == WHITE) ? 8 : -8));
+    }
+    // Na polu stoi teraz bierka, która właśnie się ruszyła (po promocji - nowa figura)
+    int onSquare = Evaluator::pieceValue(move.movedPiece);
+    if (move.promotion) {
+        onSquare = Evaluator::pieceValue(move.promotion);
+        gain[0] += onSquare - Evaluator::PAWN_VALUE;
+    }
+
+    Bitboard queens  = pos.piecesOf(WHITE, QUEEN) | pos.piecesOf(BLACK, QUEEN);
+    Bitboard bishops = pos.piecesOf(WHITE, BISHOP) | pos.piecesOf(BLACK, BISHOP) | queens;
+    Bitboard rooks   = pos.piecesOf(WHITE, ROOK) | pos.piecesOf(BLACK, ROOK) | queens;
+    Bitboard attackers = Attack::attackersTo(pos, to, occupied) & occupied;
+    Color side = ~us;
+
+    while (depth < 31) {
+        // Zakładamy odbicie przez side; jeśli ani bicie, ani rezygnacja nie ratuje
+        // poprzedniej strony, dalsza wymiana nie zmieni znaku wyniku
+        ++depth;
+        gain[depth] = onSquare - gain[depth - 1];
+        if (std::max(-gain[depth - 1], gain[depth]) < 0) break;
+
+        // Najtańszy napastnik strony side (brak - wymiana się kończy)
+        Bitboard ours = attackers & pos.colors[side];
+        if (!ours) break;
+        PieceType pt = PAWN;
+        while (!(ours & pos.piecesOf(side, pt))) pt = PieceType(pt + 1);
+
+        occupied ^= squareBB(lsb(ours & pos.piecesOf(side, pt)));
+        // Zdjęta bierka mogła odsłonić gońca/wieżę/hetmana stojącego za nią
+        if (pt == PAWN || pt == BISHOP || pt == QUEEN) attackers |= Attack::bishopAttacks(to, occupied) & bishops;
+        if (pt == ROOK || pt == QUEEN)                 attackers |= Attack::rookAttacks(to, occupied) & rooks;
+        attackers &= occupied;
+
+        onSquare = Evaluator::pieceValue(pt);
+        side = ~side;
+    }
+
+    // Od końca: każda strona wybiera między biciem a zatrzymaniem się
+    // (ostatni wpis to odbicie, do którego już nie doszło - pomijamy go)
+    while (--depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    }
+    return gain[0];
+}
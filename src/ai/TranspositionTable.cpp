@@ -1,40 +1,176 @@
 #include "chess/ai/TranspositionTable.h"
 #include <algorithm>
+#include <memory>
+#include <new>
 
-void TranspositionTable::store(uint64_t hash, int depth, int score, NodeType nodeType) {
-    // Jeśli tablica jest pełna, usuń najstarsze wpisy
-    if (table.size() >= MAX_SIZE) {
-        // Usuń wpisy o najmniejszej głębokości
-        auto it = std::min_element(table.begin(), table.end(),
-            [](const auto& a, const auto& b) {
-                return a.second.depth < b.second.depth;
-            });
-        if (it != table.end()) {
-            table.erase(it);
+#if defined(__linux__)
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#endif
+
+namespace {
+    constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+#if defined(__linux__)
+    // THP wyłączone ("[never]") - madvise się uda, ale stron huge nie będzie
+    bool transparentHugePagesDisabled() {
+        std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string setting;
+        if (!std::getline(file, setting)) return true;   // jądro bez THP
+        return setting.find("[never]") != std::string::npos;
+    }
+#endif
+}
+
+TranspositionTable::TranspositionTable(size_t sizeMb) {
+    if (!resize(sizeMb)) throw std::bad_alloc();
+}
+
+TranspositionTable::~TranspositionTable() {
+    release();
+}
+
+bool TranspositionTable::allocate(size_t count) {
+    // Od 2 MB wzwyż: wyrównanie i rozmiar w pełnych stronach huge; mniejsze tablice - linia cache
+    size_t bytes = count * sizeof(Bucket);
+    size_t alignment = bytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : alignof(Bucket);
+    bytes = (bytes + alignment - 1) / alignment * alignment;
+
+    // Nowy blok najpierw - przy braku pamięci stara tablica zostaje nietknięta
+    void* memory = ::operator new(bytes, std::align_val_t(alignment), std::nothrow);
+    if (!memory) return false;
+    bool isMapped = false;
+    HugePages huge = HugePages::NONE;
+
+#if defined(__linux__)
+    if (alignment == HUGE_PAGE_SIZE) {
+        if (!transparentHugePagesDisabled() && madvise(memory, bytes, MADV_HUGEPAGE) == 0) {
+            huge = HugePages::ADVISED;
+        } else {
+            // THP wyłączone w jądrze - spróbuj zarezerwowanych stron hugetlb (vm.nr_hugepages)
+            void* reserved = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (reserved != MAP_FAILED) {
+                ::operator delete(memory, std::align_val_t(alignment));
+                memory = reserved;
+                isMapped = true;
+                huge = HugePages::RESERVED;
+            }
         }
     }
-    
-    table[hash] = TranspositionEntry(depth, score, nodeType, hash);
+#endif
+
+    release();
+    buckets = static_cast<Bucket*>(memory);
+    std::uninitialized_default_construct_n(buckets, count);
+    bucketCount = count;
+    allocBytes = bytes;
+    mapped = isMapped;
+    hugePages = huge;
+    return true;
 }
 
-bool TranspositionTable::probe(uint64_t hash, int depth, int& score, NodeType& nodeType) {
-    auto it = table.find(hash);
-    if (it == table.end()) {
-        return false;
+void TranspositionTable::release() {
+    if (!buckets) return;
+    std::destroy_n(buckets, bucketCount);
+#if defined(__linux__)
+    if (mapped) {
+        munmap(buckets, allocBytes);
+    } else
+#endif
+    {
+        size_t alignment = allocBytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : alignof(Bucket);
+        ::operator delete(buckets, std::align_val_t(alignment));
     }
-    
-    const TranspositionEntry& entry = it->second;
-    
-    // Zwróć wpis tylko jeśli ma wystarczającą głębokość
-    if (entry.depth >= depth) {
-        score = entry.score;
-        nodeType = entry.nodeType;
-        return true;
+    buckets = nullptr;
+    bucketCount = 0;
+    allocBytes = 0;
+}
+
+bool TranspositionTable::resize(size_t sizeMb) {
+    // Największa potęga dwójki kubełków mieszcząca się w limicie (co najmniej jeden)
+    size_t count = std::clamp<size_t>(sizeMb, 1, MAX_SIZE_MB) * 1024 * 1024 / sizeof(Bucket);
+    size_t pow2 = 1;
+    while (pow2 * 2 <= count) pow2 *= 2;
+
+    if (pow2 == bucketCount) return true;   // bez realokacji w trakcie partii
+
+    if (!allocate(pow2)) return false;
+    mask = pow2 - 1;
+    clear();
+    return true;
+}
+
+void TranspositionTable::store(uint64_t hash, int depth, int score, NodeType nodeType, PackedMove move) {
+    Bucket& bucket = bucketFor(hash);
+    uint16_t key = keyOf(hash);
+
+    // Wpis do nadpisania: ten sam klucz lub pusty; inaczej najmniej wartościowy -
+    // najpłytszy, z karą za każde pokolenie wieku (stare wyniki mniej się przydają)
+    std::atomic<uint64_t>* victim = &bucket.entries[0];
+    int victimWorth = INT32_MAX;
+    uint16_t oldMove = 0;
+    for (std::atomic<uint64_t>& slot : bucket.entries) {
+        Entry e = Entry::unpack(slot.load(std::memory_order_relaxed));
+        if (e.empty() || e.key16 == key) {
+            // Ten sam klucz: płytszy wynik nie wypiera głębszego z tego samego wyszukiwania
+            if (!e.empty() && depth < e.depth && nodeType != NodeType::EXACT &&
+                e.generation() == generation) return;
+            victim = &slot;
+            if (!e.empty()) oldMove = e.move16;
+            break;
+        }
+        int age = (generation - e.generation()) & 63;
+        int worth = e.depth - 8 * age;
+        if (worth < victimWorth) {
+            victimWorth = worth;
+            victim = &slot;
+        }
+    }
+
+    Entry e;
+    e.key16 = key;
+    e.move16 = move.isNone() ? oldMove : move.raw();
+    e.score = static_cast<int16_t>(std::clamp(score, INT16_MIN + 1, INT16_MAX - 1));
+    e.depth = static_cast<uint8_t>(std::clamp(depth, 0, 255));
+    e.genBound = static_cast<uint8_t>((generation << 2) | (static_cast<int>(nodeType) + 1));
+    victim->store(e.pack(), std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(uint64_t hash, int depth, int& score, NodeType& nodeType, PackedMove& move) const {
+    const Bucket& bucket = bucketFor(hash);
+    uint16_t key = keyOf(hash);
+    move = PackedMove();
+
+    for (const std::atomic<uint64_t>& slot : bucket.entries) {
+        Entry e = Entry::unpack(slot.load(std::memory_order_relaxed));
+        if (e.empty() || e.key16 != key) continue;
+
+        // Ruch przydaje się do porządkowania niezależnie od głębokości wpisu
+        move = PackedMove(e.move16);
+
+        // Zwróć wpis tylko jeśli ma wystarczającą głębokość
+        if (e.depth >= depth) {
+            score = e.score;
+            nodeType = e.bound();
+            return true;
+        }
+        return false;
     }
-    
     return false;
 }
 
+PackedMove TranspositionTable::probeMove(uint64_t hash) const {
+    int score;
+    NodeType nodeType;
+    PackedMove move;
+    probe(hash, 0, score, nodeType, move);
+    return move;
+}
+
 void TranspositionTable::clear() {
-    table.clear();
+    for (size_t i = 0; i < bucketCount; ++i)
+        for (std::atomic<uint64_t>& slot : buckets[i].entries)
+            slot.store(0, std::memory_order_relaxed);
 }
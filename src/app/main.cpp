@@ -1,12 +1,21 @@
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <string>
+#include <vector>
 #include <cctype>
 #include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <new>
 #include <optional>
 #include "chess/board/Board.h"
 #include "chess/model/Move.h"
+#include "chess/model/PackedMove.h"
 #include "chess/game/GameState.h"
 #include "chess/ai/ChessAI.h"
+#include "chess/ai/TranspositionTable.h"
+#include "chess/rules/MoveGenerator.h"
 
 
 static int fileToCol(char f) { return f - 'a'; } // a..h -> 0..7
@@ -59,18 +68,228 @@ static bool printStateAndShouldEnd(Board& board) {
     return state != GameState::PLAYING; // true => koniec partii
 }
 
-static uint64_t perft(Board b, int depth){
+// Licznik alokacji na stercie (dla 'bench') - podmieniamy globalny operator new.
+// Atomowy: 'smp' i 'aborttest' alokują z kilku wątków naraz
+static std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+// Bez wstawiania: GCC widzi wtedy free() na wyniku operator new i zgłasza -Wmismatched-new-delete
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static uint64_t perft(Position& pos, int depth){
     if (depth == 0) return 1;
     uint64_t nodes = 0;
-    auto moves = b.getLegalMoves();
+    MoveList moves;              // na stosie, bez alokacji
+    MoveGenerator::generateLegalMoves(pos, moves);
     for (const auto& m : moves){
-        Board nb = b;            // kopia
-        nb.makeMove(m);
-        nodes += perft(nb, depth - 1);
+        pos.makeMove(m);         // w miejscu, bez kopii planszy
+        nodes += perft(pos, depth - 1);
+        pos.unmakeMove(m);
     }
     return nodes;
 }
 
+// To samo przez opakowanie zwracające std::vector - punkt odniesienia dla 'bench'
+static uint64_t perftVector(Position& pos, int depth){
+    if (depth == 0) return 1;
+    uint64_t nodes = 0;
+    std::vector<Move> moves = MoveGenerator::generateLegalMoves(pos);
+    for (const auto& m : moves){
+        pos.makeMove(m);
+        nodes += perftVector(pos, depth - 1);
+        pos.unmakeMove(m);
+    }
+    return nodes;
+}
+
+// Sprawdzenie węższych generatorów: bicia/ciche/ucieczki muszą być dokładnie
+// odfiltrowanym podzbiorem pełnej listy legalnych ruchów (w każdym węźle drzewa);
+// przy okazji każdy legalny ruch przechodzi przez PackedMove i UCI/LAN bez zmian
+static bool sameMoves(std::vector<Move> a, std::vector<Move> b){
+    auto key = [](const Move& m){ return ((m.fromRow * 8 + m.fromCol) * 64 + m.toRow * 8 + m.toCol) * 128 + m.promotion; };
+    auto less = [&](const Move& x, const Move& y){ return key(x) < key(y); };
+    std::sort(a.begin(), a.end(), less);
+    std::sort(b.begin(), b.end(), less);
+    return a == b;
+}
+
+static uint64_t genTest(Position& pos, int depth, uint64_t& nodes){
+    MoveList all, captures, quiets, evasions;
+    MoveGenerator::generateLegalMoves(pos, all);
+    MoveGenerator::generateCaptures(pos, captures);
+    MoveGenerator::generateQuiets(pos, quiets);
+    MoveGenerator::generateEvasions(pos, evasions);
+
+    std::vector<Move> wantCaptures, wantQuiets, wantEvasions;
+    bool inCheck = MoveGenerator::isInCheck(pos);
+    for (const Move& m : all) {
+        bool enPassant = std::toupper(m.movedPiece) == 'P' && m.fromCol != m.toCol && !m.capturedPiece;
+        if (m.capturedPiece || m.promotion || enPassant) wantCaptures.push_back(m);
+        else wantQuiets.push_back(m);
+        if (inCheck) wantEvasions.push_back(m);
+    }
+
+    nodes++;
+    uint64_t errors = 0;
+    if (!sameMoves(captures.toVector(), wantCaptures)) errors++;
+    if (!sameMoves(quiets.toVector(), wantQuiets)) errors++;
+    if (!sameMoves(evasions.toVector(), wantEvasions)) errors++;
+
+    // Kodowanie 16-bitowe i zapis tekstowy: Move -> PackedMove -> Move oraz UCI/LAN tam i z powrotem
+    for (const Move& m : all) {
+        PackedMove packed = PackedMove::fromMove(m);
+        if (!(packed.toMove(pos) == m)) errors++;
+        if (PackedMove::fromUci(packed.toUci(), pos) != packed) errors++;
+        if (PackedMove::fromUci(packed.toLan(), pos) != packed) errors++;
+    }
+
+    if (depth > 1) {
+        for (const auto& m : all) {
+            pos.makeMove(m);
+            errors += genTest(pos, depth - 1, nodes);
+            pos.unmakeMove(m);
+        }
+    }
+    return errors;
+}
+
+// Mikrobenchmark generatora: czas i alokacje na węzeł dla MoveList i std::vector
+template <typename PerftFn>
+static void benchPerft(const char* name, PerftFn fn, const Position& start, int depth){
+    // Węzły wewnętrzne (tam działa generator): suma perft(k) dla k < depth
+    uint64_t interior = 0;
+    for (int k = 0; k < depth; ++k) {
+        Position p = start;
+        interior += perft(p, k);
+    }
+
+    Position pos = start;
+    uint64_t allocsBefore = allocationCount.load(std::memory_order_relaxed);
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t nodes = fn(pos, depth);
+    auto t1 = std::chrono::steady_clock::now();
+    uint64_t allocs = allocationCount.load(std::memory_order_relaxed) - allocsBefore;
+    double sec = std::chrono::duration<double>(t1 - t0).count();
+
+    std::cout << name << ": perft(" << depth << ") = " << nodes
+              << ", czas " << static_cast<int>(sec * 1000) << " ms"
+              << ", " << static_cast<uint64_t>(nodes / (sec > 0 ? sec : 1e-9)) << " węzłów/s"
+              << ", alokacje " << allocs
+              << " (" << static_cast<double>(allocs) / interior << " na węzeł wewnętrzny)\n";
+}
+
+// Wydajność generatora: perft na sześciu pozycjach referencyjnych (chessprogramming.org),
+// z kontrolą liczby węzłów - ta sama miara dla porównań między wersjami generatora
+static bool perftSuite(int depth){
+    struct Reference { const char* fen; uint64_t nodes[5]; };   // perft(1..5)
+    static const Reference POSITIONS[] = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", {20, 400, 8902, 197281, 4865609}},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", {48, 2039, 97862, 4085603, 193690690}},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", {14, 191, 2812, 43238, 674624}},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", {6, 264, 9467, 422333, 15833292}},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", {44, 1486, 62379, 2103487, 89941194}},
+        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", {46, 2079, 89890, 3894594, 164075551}},
+    };
+    bool ok = true;
+    uint64_t total = 0;
+    double sec = 0;
+    for (const Reference& ref : POSITIONS) {
+        Board board;
+        board.setPositionFromFEN(ref.fen);
+        Position pos = board.position;
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t nodes = perft(pos, depth);
+        sec += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        total += nodes;
+        bool known = depth >= 1 && depth <= 5;
+        if (known && nodes != ref.nodes[depth - 1]) {
+            ok = false;
+            std::cout << "perft(" << depth << ") = " << nodes << ", oczekiwano " << ref.nodes[depth - 1]
+                      << ": " << ref.fen << "\n";
+        }
+    }
+    std::cout << "perftsuite(" << depth << "): węzły " << total << ", czas " << static_cast<int>(sec * 1000)
+              << " ms, " << static_cast<uint64_t>(total / (sec > 0 ? sec : 1e-9)) << " węzłów/s"
+              << (ok ? " OK" : " BŁĄD") << "\n";
+    return ok;
+}
+
+// Skalowanie Lazy SMP: to samo wyszukiwanie na 1, 2, 4 i 8 wątkach (wspólna TT)
+static void benchThreads(const Board& board, int depth){
+    for (int threads : {1, 2, 4, 8}) {
+        ChessAI ai;
+        ai.setThreads(threads);
+        ai.setVerbose(false);
+        auto t0 = std::chrono::steady_clock::now();
+        SearchResult result = ai.findBestMove(board.board, board.activeColor, board.state, depth, 600000);
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        std::cout << "wątki " << threads << ": głębokość " << result.depth
+                  << ", czas " << static_cast<int>(sec * 1000) << " ms"
+                  << ", węzły " << ai.getNodesVisited()
+                  << ", " << static_cast<uint64_t>(ai.getNodesVisited() / (sec > 0 ? sec : 1e-9)) << " węzłów/s"
+                  << ", trafienia TT " << static_cast<int>(ai.getTTHitRate() * 1000) / 10.0 << "%"
+                  << ", piony " << static_cast<int>(ai.getPawnHitRate() * 1000) / 10.0 << "%"
+                  << ", ocena " << static_cast<int>(ai.getEvalHitRate() * 1000) / 10.0 << "%"
+                  << ", ruch " << PackedMove::fromMove(result.bestMove).toLan() << "\n";
+    }
+}
+
+// Regresja: przerwane wyszukiwanie (pomocnicy Lazy SMP zatrzymani w trakcie) nie może zostawić
+// w TT ocen z przerwanych węzłów - ponowne wyszukiwanie na tej samej TT daje wynik jak od zera
+static bool checkAbortedSearch(const Board& board, int depth){
+    ChessAI fresh;
+    fresh.setVerbose(false);
+    int expected = fresh.findBestMove(board.board, board.activeColor, board.state, depth, 600000).score;
+
+    ChessAI ai;
+    ai.setVerbose(false);
+    ai.setThreads(8);    // po zakończeniu głównego wątku pomocnicy są przerywani w pół węzła
+    for (int round = 0; round < 3; round++)
+        ai.findBestMove(board.board, board.activeColor, board.state, depth, 600000);
+    ai.setThreads(1);
+    int again = ai.findBestMove(board.board, board.activeColor, board.state, depth, 600000).score;
+
+    bool ok = expected == again;
+    std::cout << "aborttest(" << depth << "): " << expected << " / " << again << (ok ? " OK" : " BŁĄD") << "\n";
+    return ok;
+}
+
+// Wyszukiwanie na kilku pozycjach z TT zadanego rozmiaru - przy TT większej niż L3 widać
+// koszt chybień cache przy probe (porównanie buildów z i bez CHESS_TT_PREFETCH)
+static void benchSearch(int depth, size_t hashMb){
+    static const char* FENS[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/R2QKB1R w KQ - 0 8",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+    std::cout << "prefetch TT: " << (TranspositionTable::PREFETCH_ENABLED ? "tak" : "nie") << "\n";
+    uint64_t nodes = 0;
+    double sec = 0;
+    for (const char* fen : FENS) {
+        Board board;
+        board.setPositionFromFEN(fen);
+        ChessAI ai;
+        if (!ai.setHashSize(hashMb)) {
+            std::cout << "Brak pamięci na TT " << hashMb << " MB\n";
+            return;
+        }
+        ai.setVerbose(false);
+        auto t0 = std::chrono::steady_clock::now();
+        ai.findBestMove(board.board, board.activeColor, board.state, depth, 600000);
+        sec += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        nodes += ai.getNodesVisited();
+    }
+    std::cout << "TT " << hashMb << " MB: węzły " << nodes << ", czas " << static_cast<int>(sec * 1000)
+              << " ms, " << static_cast<uint64_t>(nodes / (sec > 0 ? sec : 1e-9)) << " węzłów/s\n";
+}
+
 int main()
 {
     Board board;
@@ -79,6 +298,8 @@ int main()
 
     std::cout << "Podaj ruch (np. e2e4, e7e8Q). 'quit' aby wyjsc.\n";
 
+    ChessAI ai;   // jeden silnik na partię - TT przechodzi między ruchami AI
+
     std::string s;
     while (true)
     {
@@ -87,14 +308,70 @@ int main()
             break;
         if (s == "quit" || s == "exit")
             break;
-        if (s == "perft") {
-            board.startBoard();
+        if (s == "perft") {       // z bieżącej pozycji (po 'fen' lub ruchach)
             int d = 0;
             if (!(std::cin >> d)) { std::cout << "Użycie: perft <depth>\n"; break; }
-            uint64_t n = perft(board, d);
+            Position pos = board.position;
+            uint64_t n = perft(pos, d);
             std::cout << "perft(" << d << ") = " << n << "\n";
             continue;
         }
+        if (s == "gentest") {     // z bieżącej pozycji, jak perft
+            int d = 0;
+            if (!(std::cin >> d)) { std::cout << "Użycie: gentest <depth>\n"; break; }
+            Position pos = board.position;
+            uint64_t nodes = 0;
+            uint64_t errors = genTest(pos, d, nodes);
+            std::cout << "gentest(" << d << "): węzły " << nodes << ", błędy " << errors << "\n";
+            continue;
+        }
+        if (s == "perftsuite") {  // sześć pozycji referencyjnych, niezależnie od bieżącej
+            int d = 0;
+            if (!(std::cin >> d)) { std::cout << "Użycie: perftsuite <depth>\n"; break; }
+            perftSuite(d);
+            continue;
+        }
+        if (s == "bench") {       // z pozycji startowej na osobnej planszy - partia zostaje
+            int d = 0;
+            if (!(std::cin >> d)) { std::cout << "Użycie: bench <depth>\n"; break; }
+            Board start;
+            start.startBoard();
+            benchPerft("MoveList   ", perft, start.position, d);
+            benchPerft("std::vector", perftVector, start.position, d);
+            continue;
+        }
+        if (s == "hash") {        // rozmiar TT w MB; zawartość tracona tylko przy zmianie rozmiaru
+            long long mb = 0;
+            if (!(std::cin >> mb)) { std::cout << "Użycie: hash <MB>\n"; break; }
+            if (mb < 1) { std::cout << "Rozmiar TT musi być dodatni (MB)\n"; continue; }
+            if (!ai.setHashSize(static_cast<size_t>(mb)))
+                std::cout << "Brak pamięci na " << mb << " MB - TT bez zmian\n";
+            std::cout << "TT: " << ai.getHashSizeMb() << " MB"
+                      << (ai.hashHugePages() == HugePages::RESERVED ? " (strony huge)"
+                          : ai.hashHugePages() == HugePages::ADVISED ? " (strony huge zamówione przez madvise, przydziela THP)"
+                          : "") << "\n";
+            continue;
+        }
+        if (s == "ttbench") {
+            int d = 0;
+            long long mb = 0;
+            if (!(std::cin >> d >> mb)) { std::cout << "Użycie: ttbench <depth> <MB>\n"; break; }
+            if (mb < 1) { std::cout << "Rozmiar TT musi być dodatni (MB)\n"; continue; }
+            benchSearch(d, static_cast<size_t>(mb));
+            continue;
+        }
+        if (s == "aborttest") {   // z bieżącej pozycji
+            int d = 0;
+            if (!(std::cin >> d)) { std::cout << "Użycie: aborttest <depth>\n"; break; }
+            checkAbortedSearch(board, d);
+            continue;
+        }
+        if (s == "smp") {         // z bieżącej pozycji
+            int d = 0;
+            if (!(std::cin >> d)) { std::cout << "Użycie: smp <depth>\n"; break; }
+            benchThreads(board, d);
+            continue;
+        }
         
         if (s == "ai") {
             int depth = 5;  // Domyślna głębokość
@@ -111,28 +388,24 @@ int main()
                 }
             }
             
-            ChessAI ai;
             std::cout << "AI szuka najlepszego ruchu (głębokość: " << depth << ", czas: " << timeMs << "ms)...\n";
-            SearchResult result = ai.findBestMove(board.board, board.activeColor, 
-                                               board.castling, board.enPassant, depth, timeMs);
+            SearchResult result = ai.findBestMove(board.board, board.activeColor, board.state,
+                                               depth, timeMs);
             
             std::cout << "Najlepszy ruch znaleziony\n";
             std::cout << "Ocena: " << result.score << "\n";
             std::cout << "Głębokość: " << result.depth << "\n";
             std::cout << "Węzły: " << result.nodesVisited << "\n";
             std::cout << "Czas: " << result.timeSpent.count() << "ms\n";
+            std::cout << "Trafienia TT: " << static_cast<int>(ai.getTTHitRate() * 1000) / 10.0
+                      << "%, hash pionów: " << static_cast<int>(ai.getPawnHitRate() * 1000) / 10.0
+                      << "%, cache oceny: " << static_cast<int>(ai.getEvalHitRate() * 1000) / 10.0 << "%\n";
             
             // Wykonaj ruch AI
             if (board.isMoveValid(result.bestMove)) {
                 // Konwertuj ruch na notację LAN
-                std::string aiMove = "";
-                aiMove += static_cast<char>('a' + result.bestMove.fromCol);
-                aiMove += static_cast<char>('8' - result.bestMove.fromRow);
-                aiMove += static_cast<char>('a' + result.bestMove.toCol);
-                aiMove += static_cast<char>('8' - result.bestMove.toRow);
-                if (result.bestMove.promotion) {
-                    aiMove += result.bestMove.promotion;
-                }
+                std::string aiMove = PackedMove::fromMove(result.bestMove).toLan();
+                if (MoveGenerator::givesCheck(board.position, result.bestMove)) aiMove += '+';
                 
                 board.makeMove(result.bestMove);
                 std::cout << "Ruch AI: " << aiMove << "\n";
@@ -153,6 +426,7 @@ int main()
             if (!fen.empty()) {
                 // Ustaw pozycję z FEN
                 board.setPositionFromFEN(fen);
+                ai.newGame();
                 std::cout << "Pozycja ustawiona z FEN\n";
                 board.printBoard();
             }
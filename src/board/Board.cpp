@@ -4,6 +4,7 @@
 #include <sstream>
 #include <string>
 #include <cctype>
+#include "chess/utils/Notation.h"
 
 
 bool Board::loadFEN(const std::string& fen) {
@@ -32,10 +33,11 @@ bool Board::loadFEN(const std::string& fen) {
 
     // pozostałe pola stanu
     activeColor    = (active == "w" ? 'w' : 'b');
-    castling       = (castl == "-" ? "" : castl);
-    enPassant      = (ep == "-" ? "" : ep);
-    halfmoveClock  = half;
-    fullmoveNumber = full;
+    state.castling       = notation::castlingFromString(castl);
+    state.epSquare       = static_cast<int8_t>(notation::algToSquare(ep));
+    state.halfmoveClock  = half;
+    state.fullmoveNumber = full;
+    syncPosition();
     return true;
 }
 
@@ -74,10 +76,10 @@ void Board::setPositionFromFEN(const std::string& fen) {
         if (i < fen.length()) {
             size_t spacePos = fen.find(' ', i);
             if (spacePos != std::string::npos) {
-                castling = fen.substr(i, spacePos - i);
+                state.castling = notation::castlingFromString(fen.substr(i, spacePos - i));
                 i = spacePos + 1;
             } else {
-                castling = "-";
+                state.castling = 0;
                 i = fen.length();
             }
         }
@@ -86,10 +88,10 @@ void Board::setPositionFromFEN(const std::string& fen) {
         if (i < fen.length()) {
             size_t spacePos = fen.find(' ', i);
             if (spacePos != std::string::npos) {
-                enPassant = fen.substr(i, spacePos - i);
+                state.epSquare = static_cast<int8_t>(notation::algToSquare(fen.substr(i, spacePos - i)));
                 i = spacePos + 1;
             } else {
-                enPassant = "-";
+                state.epSquare = NO_SQUARE;
                 i = fen.length();
             }
         }
@@ -98,24 +100,25 @@ void Board::setPositionFromFEN(const std::string& fen) {
         if (i < fen.length()) {
             size_t spacePos = fen.find(' ', i);
             if (spacePos != std::string::npos) {
-                halfmoveClock = std::stoi(fen.substr(i, spacePos - i));
+                state.halfmoveClock = std::stoi(fen.substr(i, spacePos - i));
                 i = spacePos + 1;
             } else {
-                halfmoveClock = 0;
+                state.halfmoveClock = 0;
                 i = fen.length();
             }
         }
 
         // Parsuj numer ruchu
         if (i < fen.length()) {
-            fullmoveNumber = std::stoi(fen.substr(i));
+            state.fullmoveNumber = std::stoi(fen.substr(i));
         } else {
-            fullmoveNumber = 1;
+            state.fullmoveNumber = 1;
         }
     }
 
+    syncPosition();
     gameStateManager.clearHistory();
-    gameStateManager.addPosition(board, activeColor, castling, enPassant);
+    gameStateManager.addPosition(position);
 }
 
 void Board::printBoard() const {
@@ -126,24 +129,23 @@ void Board::printBoard() const {
         std::cout << '\n';
     }
     std::cout << "Active color: " << activeColor << '\n';
-    std::cout << "Castling: " << castling << '\n';
-    std::cout << "En passant: " << enPassant << '\n';
-    std::cout << "Halfmove clock: " << halfmoveClock << '\n';
-    std::cout << "Fullmove number: " << fullmoveNumber << '\n';
+    std::cout << "Castling: " << notation::castlingToString(state.castling) << '\n';
+    std::cout << "En passant: " << notation::squareToAlg(state.epSquare) << '\n';
+    std::cout << "Halfmove clock: " << state.halfmoveClock << '\n';
+    std::cout << "Fullmove number: " << state.fullmoveNumber << '\n';
 }
 
 std::vector<Move> Board::getLegalMoves() const {
-    return MoveGenerator::generateLegalMoves(board, activeColor, castling, enPassant);
+    return MoveGenerator::generateLegalMoves(position);
 }
 bool Board::hasLegalMoves() const {
-    return MoveGenerator::hasLegalMoves(board, activeColor, castling, enPassant);
+    return MoveGenerator::hasLegalMoves(position);
 }
 bool Board::isInCheck() const {
-    return MoveGenerator::isInCheck(board, activeColor);
+    return MoveGenerator::isInCheck(position);
 }
 GameState Board::getGameState() const {
-    return gameStateManager.checkGameState(board, activeColor, castling, enPassant,
-                                          halfmoveClock, hasLegalMoves(), isInCheck());
+    return gameStateManager.checkGameState(position, hasLegalMoves(), isInCheck());
 }
 std::string Board::getGameStateString() const {
     return gameStateManager.getGameStateString(getGameState(), activeColor);
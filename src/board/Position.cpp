@@ -0,0 +1,197 @@
+// Position.cpp
+#include "chess/board/Position.h"
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include "chess/ai/ZobristHash.h"
+
+#ifdef CHESS_DEBUG_HASH
+#include <iostream>
+#include <string>
+#include "chess/utils/Notation.h"
+#endif
+
+using namespace Bitboards;
+
+namespace {
+    // Maska praw roszady, które zostają po ruchu z/na dane pole (król lub wieża z rogu)
+    constexpr uint8_t ALL_RIGHTS = CASTLE_ALL;
+    constexpr uint8_t castlingKeepMask(int sq) {
+        switch (sq) {
+            case 0:  return ALL_RIGHTS & ~CASTLE_BQ;                // a8
+            case 4:  return ALL_RIGHTS & ~(CASTLE_BK | CASTLE_BQ);  // e8
+            case 7:  return ALL_RIGHTS & ~CASTLE_BK;                // h8
+            case 56: return ALL_RIGHTS & ~CASTLE_WQ;                // a1
+            case 60: return ALL_RIGHTS & ~(CASTLE_WK | CASTLE_WQ);  // e1
+            case 63: return ALL_RIGHTS & ~CASTLE_WK;                // h1
+            default: return ALL_RIGHTS;
+        }
+    }
+
+    // Litera promocji w kolorze strony wykonującej ruch (domyślnie hetman, jak w Board::makeMove)
+    inline char promotionPiece(char promotion, Color us) {
+        char p = promotion ? promotion : 'Q';
+        return us == WHITE ? std::toupper(p) : std::tolower(p);
+    }
+
+    // Indeks bierki, która na pewno stoi na polu (ruszana, bita, promowana). Warunek widoczny
+    // dla kompilatora także w Release - bez niego -Warray-bounds widzi pieceKey(NO_PIECE, ...)
+    inline int occupiedIndex(char piece) {
+        int idx = pieceIndex(piece);
+        assert(idx != NO_PIECE && "makeMove: brak bierki na polu ruchu");
+#if defined(__GNUC__) || defined(__clang__)
+        if (idx < 0) __builtin_unreachable();
+#endif
+        return idx;
+    }
+
+#ifdef CHESS_DEBUG_HASH
+    // FEN pozycji do komunikatu o rozjechanym hashu (tylko w buildzie kontrolnym)
+    std::string debugFen(const Position& pos) {
+        std::string fen;
+        for (int r = 0; r < 8; ++r) {
+            int empty = 0;
+            for (int c = 0; c < 8; ++c) {
+                char p = pos.board[r][c];
+                if (!p) { ++empty; continue; }
+                if (empty) { fen += char('0' + empty); empty = 0; }
+                fen += p;
+            }
+            if (empty) fen += char('0' + empty);
+            if (r < 7) fen += '/';
+        }
+        fen += pos.sideToMove == WHITE ? " w " : " b ";
+        fen += notation::castlingToString(pos.state.castling) + " " + notation::squareToAlg(pos.state.epSquare);
+        fen += " " + std::to_string(pos.state.halfmoveClock) + " " + std::to_string(pos.state.fullmoveNumber);
+        return fen;
+    }
+#endif
+}
+
+void Position::setFromMailbox(const char src[8][8]) {
+    for (auto& p : pieces) p = 0;
+    colors[WHITE] = colors[BLACK] = 0;
+    occupied = 0;
+    undoCount = 0;
+
+    for (int r = 0; r < 8; ++r) {
+        for (int c = 0; c < 8; ++c) {
+            board[r][c] = 0;
+            if (src[r][c] && pieceIndex(src[r][c]) != NO_PIECE)
+                putPiece(src[r][c], square(r, c));
+        }
+    }
+    hash = ZobristHash::calculateHash(*this);
+    pawnHash = ZobristHash::calculatePawnHash(*this);
+}
+
+void Position::setState(Color side, const PositionState& st) {
+    sideToMove = side;
+    state = st;
+    undoCount = 0;
+    hash = ZobristHash::calculateHash(*this);
+}
+
+void Position::makeMove(const Move& move) {
+    UndoInfo& undo = undoStack[undoCount++];
+    undo.hash = hash;
+    undo.pawnHash = pawnHash;
+    undo.state = state;
+
+    Color us = sideToMove;
+    int from = square(move.fromRow, move.fromCol);
+    int to   = square(move.toRow, move.toCol);
+    undo.moved = pieceAt(from);
+    int movedIdx = occupiedIndex(undo.moved);
+    PieceType pt = typeOf(movedIdx);
+
+    // Hash przyrostowo: XOR-em zdejmujemy stare składniki i dokładamy nowe
+    uint64_t h = hash ^ ZobristHash::castlingKey(state.castling);
+    if (state.epSquare != NO_SQUARE) h ^= ZobristHash::enPassantKey(state.epSquare);
+
+    // Bicie (w przelocie - pion stoi obok, na rzędzie startowym bijącego)
+    int capSq = (pt == PAWN && to == state.epSquare && move.fromCol != move.toCol)
+              ? square(move.fromRow, move.toCol) : to;
+    undo.captured = pieceAt(capSq);
+    if (undo.captured) {
+        int capturedIdx = occupiedIndex(undo.captured);
+        h ^= ZobristHash::pieceKey(capturedIdx, capSq);
+        if (typeOf(capturedIdx) == PAWN) pawnHash ^= ZobristHash::pieceKey(capturedIdx, capSq);
+        removePiece(capSq);
+    }
+
+    movePiece(from, to);
+    h ^= ZobristHash::pieceKey(movedIdx, from) ^ ZobristHash::pieceKey(movedIdx, to);
+    if (pt == PAWN) pawnHash ^= ZobristHash::pieceKey(movedIdx, from) ^ ZobristHash::pieceKey(movedIdx, to);
+
+    if (pt == PAWN && (move.toRow == 0 || move.toRow == 7)) {
+        char promoted = promotionPiece(move.promotion, us);
+        removePiece(to);
+        putPiece(promoted, to);
+        h ^= ZobristHash::pieceKey(movedIdx, to) ^ ZobristHash::pieceKey(occupiedIndex(promoted), to);
+        pawnHash ^= ZobristHash::pieceKey(movedIdx, to);   // pion znika z planszy
+    }
+
+    // Roszada: przestaw wieżę
+    if (pt == KING && std::abs(move.toCol - move.fromCol) == 2) {
+        int r = move.fromRow;
+        int rookFrom = square(r, move.toCol == 6 ? 7 : 0);   // O-O / O-O-O
+        int rookTo   = square(r, move.toCol == 6 ? 5 : 3);
+        int rookIdx  = makePiece(us, ROOK);
+        movePiece(rookFrom, rookTo);
+        h ^= ZobristHash::pieceKey(rookIdx, rookFrom) ^ ZobristHash::pieceKey(rookIdx, rookTo);
+    }
+
+    state.castling &= castlingKeepMask(from) & castlingKeepMask(to);
+    state.epSquare = (pt == PAWN && std::abs(to - from) == 16) ? static_cast<int8_t>((from + to) / 2) : NO_SQUARE;
+    state.halfmoveClock = (pt == PAWN || undo.captured) ? 0 : state.halfmoveClock + 1;
+    if (us == BLACK) state.fullmoveNumber++;
+    sideToMove = ~us;
+
+    h ^= ZobristHash::castlingKey(state.castling) ^ ZobristHash::sideKey();
+    if (state.epSquare != NO_SQUARE) h ^= ZobristHash::enPassantKey(state.epSquare);
+    hash = h;
+
+#ifdef CHESS_DEBUG_HASH
+    // Bez assert - kontrola działa także w Release (NDEBUG) z -DCHESS_DEBUG_HASH=ON
+    bool hashOk = hash == ZobristHash::calculateHash(*this);
+    bool pawnHashOk = pawnHash == ZobristHash::calculatePawnHash(*this);
+    if (!hashOk || !pawnHashOk) {
+        unmakeMove(move);
+        std::cerr << "CHESS_DEBUG_HASH: przyrostowy " << (hashOk ? "hash pionów" : "hash Zobrista")
+                  << " rozjechał się z pełnym\n  pozycja: " << debugFen(*this)
+                  << "\n  ruch: " << notation::coordToAlg(move.fromRow, move.fromCol)
+                  << notation::coordToAlg(move.toRow, move.toCol) << std::endl;
+        std::abort();
+    }
+#endif
+}
+
+void Position::unmakeMove(const Move& move) {
+    const UndoInfo& undo = undoStack[--undoCount];
+    sideToMove = ~sideToMove;
+
+    int from = square(move.fromRow, move.fromCol);
+    int to   = square(move.toRow, move.toCol);
+    PieceType pt = typeOf(pieceIndex(undo.moved));
+
+    // Cofnij roszadę
+    if (pt == KING && std::abs(move.toCol - move.fromCol) == 2) {
+        int r = move.fromRow;
+        if (move.toCol == 6) movePiece(square(r, 5), square(r, 7));
+        else                 movePiece(square(r, 3), square(r, 0));
+    }
+
+    // Na pole startowe wraca bierka sprzed ruchu (przy promocji - pion)
+    removePiece(to);
+    putPiece(undo.moved, from);
+
+    if (undo.captured) {
+        bool enPassant = pt == PAWN && to == undo.state.epSquare && move.fromCol != move.toCol;
+        putPiece(undo.captured, enPassant ? square(move.fromRow, move.toCol) : to);
+    }
+
+    hash = undo.hash;
+    pawnHash = undo.pawnHash;
+    state = undo.state;
+}
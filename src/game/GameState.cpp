@@ -2,9 +2,8 @@
 #include "chess/game/GameState.h"
 #include <cctype>
 
-void GameStateManager::addPosition(const char board[8][8], char activeColor, 
-                                  const std::string& castling, const std::string& enPassant) {
-    std::string position = boardToString(board, activeColor, castling, enPassant);
+void GameStateManager::addPosition(const Position& pos) {
+    std::string position = boardToString(pos);
     positionHistory[position]++;
 }
 
@@ -12,20 +11,18 @@ void GameStateManager::clearHistory() {
     positionHistory.clear();
 }
 
-GameState GameStateManager::checkGameState(const char board[8][8], char activeColor, 
-                                         const std::string& castling, const std::string& enPassant,
-                                         int halfmoveClock, bool hasLegalMoves, bool isInCheck) const {
-    if (halfmoveClock >= 100) {
+GameState GameStateManager::checkGameState(const Position& pos, bool hasLegalMoves, bool isInCheck) const {
+    if (pos.state.halfmoveClock >= 100) {
         return GameState::DRAW_50_MOVES;
     }
     
-    std::string currentPosition = boardToString(board, activeColor, castling, enPassant);
+    std::string currentPosition = boardToString(pos);
     auto it = positionHistory.find(currentPosition);
     if (it != positionHistory.end() && it->second >= 3) {
         return GameState::DRAW_REPETITION;
     }
     
-    if (hasInsufficientMaterial(board)) {
+    if (hasInsufficientMaterial(pos)) {
         return GameState::DRAW_INSUFFICIENT_MATERIAL;
     }
     
@@ -59,64 +56,33 @@ std::string GameStateManager::getGameStateString(GameState state, char activeCol
     }
 }
 
-std::string GameStateManager::boardToString(const char board[8][8], char activeColor, 
-                                           const std::string& castling, const std::string& enPassant) const {
+std::string GameStateManager::boardToString(const Position& pos) const {
     std::string result;
+    result.reserve(64 + 3);
     for (int r = 0; r < 8; r++) {
         for (int c = 0; c < 8; c++) {
-            result += (board[r][c] ? board[r][c] : '.');
+            result += (pos.board[r][c] ? pos.board[r][c] : '.');
         }
     }
-    result += activeColor;
-    result += castling;
-    result += enPassant;
+    // Strona, maska roszad i kolumna EP - po jednym znaku (liczniki nie wchodzą do klucza)
+    result += toColorChar(pos.sideToMove);
+    result += static_cast<char>('A' + pos.state.castling);
+    result += (pos.state.epSquare != NO_SQUARE) ? static_cast<char>('a' + Bitboards::colOf(pos.state.epSquare)) : '-';
     return result;
 }
 
-bool GameStateManager::hasInsufficientMaterial(const char board[8][8]) const {
-    int wKing = 0, bKing = 0;
-    int wQueen = 0, bQueen = 0;
-    int wRook = 0, bRook = 0;
-    int wBishop = 0, bBishop = 0;
-    int wKnight = 0, bKnight = 0;
-    int wPawn = 0, bPawn = 0;
-    
-    for (int r = 0; r < 8; r++) {
-        for (int c = 0; c < 8; c++) {
-            switch (board[r][c]) {
-                case 'K': wKing++; break;
-                case 'k': bKing++; break;
-                case 'Q': wQueen++; break;
-                case 'q': bQueen++; break;
-                case 'R': wRook++; break;
-                case 'r': bRook++; break;
-                case 'B': wBishop++; break;
-                case 'b': bBishop++; break;
-                case 'N': wKnight++; break;
-                case 'n': bKnight++; break;
-                case 'P': wPawn++; break;
-                case 'p': bPawn++; break;
-            }
-        }
-    }
-    
-    if (wPawn || bPawn || wQueen || bQueen || wRook || bRook) {
+bool GameStateManager::hasInsufficientMaterial(const Position& pos) const {
+    using Bitboards::popCount;
+
+    // Piony, wieże lub hetmany na planszy - zawsze da się zamatować
+    if (pos.piecesOf(WHITE, PAWN) | pos.piecesOf(BLACK, PAWN) |
+        pos.piecesOf(WHITE, ROOK) | pos.piecesOf(BLACK, ROOK) |
+        pos.piecesOf(WHITE, QUEEN) | pos.piecesOf(BLACK, QUEEN)) {
         return false;
     }
-    
-    if (wBishop == 0 && bBishop == 0 && wKnight == 0 && bKnight == 0) {
-        return true;
-    }
-    
-    if ((wBishop == 1 && bBishop == 0 && wKnight == 0 && bKnight == 0) ||
-        (wBishop == 0 && bBishop == 1 && wKnight == 0 && bKnight == 0)) {
-        return true;
-    }
-    
-    if ((wKnight == 1 && bKnight == 0 && wBishop == 0 && bBishop == 0) ||
-        (wKnight == 0 && bKnight == 1 && wBishop == 0 && bBishop == 0)) {
-        return true;
-    }
-    
-    return false;
-}
\ No newline at end of file
+
+    // Same króle albo król + jedna lekka figura (goniec lub skoczek) po jednej stronie
+    int minors = popCount(pos.piecesOf(WHITE, BISHOP) | pos.piecesOf(BLACK, BISHOP) |
+                          pos.piecesOf(WHITE, KNIGHT) | pos.piecesOf(BLACK, KNIGHT));
+    return minors <= 1;
+}
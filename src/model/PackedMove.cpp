@@ -0,0 +1,53 @@
+// PackedMove.cpp
+#include "chess/model/PackedMove.h"
+#include <cctype>
+#include <cstdlib>
+#include "chess/board/Position.h"
+#include "chess/utils/Notation.h"
+
+PackedMove PackedMove::fromMove(const Move& m) {
+    int from = m.fromRow * 8 + m.fromCol;
+    int to   = m.toRow * 8 + m.toCol;
+    char moved = static_cast<char>(std::toupper(static_cast<unsigned char>(m.movedPiece)));
+
+    if (moved == 'P' && (m.toRow == 0 || m.toRow == 7))
+        return PackedMove(from, to, PROMOTION, m.promotion ? m.promotion : 'Q');
+    if (moved == 'P' && m.fromCol != m.toCol && !m.capturedPiece)
+        return PackedMove(from, to, EN_PASSANT);
+    if (moved == 'K' && std::abs(m.toCol - m.fromCol) == 2)
+        return PackedMove(from, to, CASTLING);
+    return PackedMove(from, to);
+}
+
+Move PackedMove::toMove(const Position& pos) const {
+    int f = from(), t = to();
+    // Przy EP pole docelowe jest puste - tak jak w generatorze capturedPiece = 0
+    return {f >> 3, f & 7, t >> 3, t & 7, pos.pieceAt(f), pos.pieceAt(t), promotion()};
+}
+
+std::string PackedMove::toUci() const {
+    std::string s = notation::squareToAlg(from()) + notation::squareToAlg(to());
+    if (type() == PROMOTION) s += static_cast<char>(std::tolower(promotion()));
+    return s;
+}
+
+std::string PackedMove::toLan() const {
+    std::string s = notation::squareToAlg(from()) + notation::squareToAlg(to());
+    if (type() == PROMOTION) s += promotion();
+    return s;
+}
+
+PackedMove PackedMove::fromUci(const std::string& s, const Position& pos) {
+    if (s.size() != 4 && s.size() != 5) return PackedMove();
+    int from = notation::algToSquare(s.substr(0, 2));
+    int to   = notation::algToSquare(s.substr(2, 2));
+    if (from == NO_SQUARE || to == NO_SQUARE || !pos.pieceAt(from)) return PackedMove();
+
+    Move m{from >> 3, from & 7, to >> 3, to & 7, pos.pieceAt(from), pos.pieceAt(to), 0};
+    if (s.size() == 5) {
+        char promo = static_cast<char>(std::toupper(static_cast<unsigned char>(s[4])));
+        if (promo != 'N' && promo != 'B' && promo != 'R' && promo != 'Q') return PackedMove();
+        m.promotion = promo;
+    }
+    return fromMove(m);
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <cctype>
@@ -30,6 +31,22 @@ static std::string env_or(const char *key, const std::string &def)
     return def;
 }
 
+// Rozmiar w MB z ENV; brak, śmieci lub 0 -> wartość domyślna (z ostrzeżeniem)
+static size_t env_size_mb(const char *key, size_t def)
+{
+    const char *v = std::getenv(key);
+    if (!v || !*v)
+        return def;
+    try {
+        size_t used = 0;
+        long long mb = std::stoll(v, &used);
+        if (used == std::strlen(v) && mb > 0)
+            return static_cast<size_t>(mb);
+    } catch (...) {}
+    std::cerr << "[CONFIG] " << key << "=\"" << v << "\" is invalid, using " << def << " MB\n";
+    return def;
+}
+
 // Walidator „e2” etc.
 static inline bool valid_sq(const std::string &s)
 {
@@ -81,13 +98,13 @@ static std::string fen_from_board(const Board &b)
     out += ' ';
     out += (b.activeColor == 'w' ? 'w' : 'b');
     out += ' ';
-    out += (b.castling.empty() ? "-" : b.castling);
+    out += notation::castlingToString(b.state.castling);
     out += ' ';
-    out += (b.enPassant.empty() ? "-" : b.enPassant);
+    out += notation::squareToAlg(b.state.epSquare);
     out += ' ';
-    out += std::to_string(b.halfmoveClock);
+    out += std::to_string(b.state.halfmoveClock);
     out += ' ';
-    out += std::to_string(b.fullmoveNumber);
+    out += std::to_string(b.state.fullmoveNumber);
     return out;
 }
 
@@ -159,6 +176,15 @@ int main()
         return 1;
     }
 
+    // Jeden silnik na całą sesję - TT z poprzednich ruchów przyspiesza kolejne wyszukiwania
+    ChessAI ai;
+    if (!ai.setHashSize(env_size_mb("CHESS_HASH_MB", TranspositionTable::DEFAULT_SIZE_MB)))
+        std::cerr << "[AI] Not enough memory for CHESS_HASH_MB, keeping default hash size\n";
+    std::cout << "[AI] Hash: " << ai.getHashSizeMb() << " MB"
+              << (ai.hashHugePages() == HugePages::RESERVED ? " (huge pages)"
+                  : ai.hashHugePages() == HugePages::ADVISED ? " (huge pages requested via madvise)"
+                  : "") << std::endl;
+
     auto publish_engine_status = [&](const std::string &status, const std::string &msg = "")
     {
         json j = {{"status", status}};
@@ -305,12 +331,8 @@ int main()
                 char arr[8][8];
                 copy_board_to_array(board, arr);
                 char side = board.activeColor;              // 'w' lub 'b'
-                std::string cast = board.castling;          // "KQkq" / "-"
-                std::string ep   = board.enPassant;         // "e3" / "-"
-
 
-                ChessAI ai;
-                auto res = ai.findBestMove(arr, side, cast, ep, /*maxDepth*/5, /*maxTimeMs*/5000);
+                auto res = ai.findBestMove(arr, side, board.state, /*maxDepth*/5, /*maxTimeMs*/5000);
 
                 // Jeśli nie znalazł
                 if (res.bestMove.fromRow == 0 && res.bestMove.fromCol == 0 &&
@@ -381,6 +403,7 @@ int main()
                         std::cout << "[RESTART] No FEN provided, using start position" << std::endl;
                         board.startBoard();
                     }
+                    ai.newGame();
                     std::cout << "[RESTART] Board reset completed" << std::endl;
                     
                     // Wyślij aktualny FEN po resecie
@@ -397,6 +420,7 @@ int main()
                 } catch (...) {
                     std::cout << "[RESTART] Exception occurred, using default start position" << std::endl;
                     board.startBoard();
+                    ai.newGame();
                     client.publish(topics::STATUS_ENGINE, json{{"status","ready"},{"message","board restarted"}});
                 }
                 return;
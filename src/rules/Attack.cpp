@@ -13,61 +13,41 @@ bool Attack::isPathClear(const char board[8][8], int r1, int c1, int r2, int c2)
 }
 
 bool Attack::isSquareAttacked(const char board[8][8], int row, int col, char byColor) {
-    int dir = (byColor == 'w') ? -1 : 1;
-    char pawnChar = (byColor == 'w') ? 'P' : 'p';
-    int pr = row - dir;                         // rząd, na którym stoi pion atakujący to pole
-    if (pr >= 0 && pr < 8) {
-        if (col > 0 && board[pr][col - 1] == pawnChar) return true;
-        if (col < 7 && board[pr][col + 1] == pawnChar) return true;
-    }
+    Position pos(board);
+    return isSquareAttacked(pos, Bitboards::square(row, col), toColor(byColor));
+}
 
-    const int knightMoves[8][2] = {{-2,-1},{-2,1},{-1,-2},{-1,2},{1,-2},{1,2},{2,-1},{2,1}};
-    char knightChar = (byColor == 'w') ? 'N' : 'n';
-    for (auto &m : knightMoves) {
-        int nr = row + m[0], nc = col + m[1];
-        if (nr >= 0 && nr < 8 && nc >= 0 && nc < 8) {
-            if (board[nr][nc] == knightChar) return true;
-        }
-    }
+// --- Wersje bitboardowe ---
+bool Attack::isSquareAttacked(const Position& pos, int sq, Color byColor) {
+    return byColor == WHITE ? isSquareAttacked<WHITE>(pos, sq) : isSquareAttacked<BLACK>(pos, sq);
+}
 
-    char rookChar = (byColor == 'w') ? 'R' : 'r';
-    char queenChar = (byColor == 'w') ? 'Q' : 'q';
-    const int dirsRook[4][2] = {{1,0},{-1,0},{0,1},{0,-1}};
-    for (auto &d : dirsRook) {
-        int r = row + d[0], c = col + d[1];
-        while (r >= 0 && r < 8 && c >= 0 && c < 8) {
-            if (board[r][c] != 0) {
-                if (board[r][c] == rookChar || board[r][c] == queenChar) return true;
-                break;
-            }
-            r += d[0]; c += d[1];
-        }
-    }
+Bitboard Attack::attackedBy(const Position& pos, Color byColor, Bitboard occupied) {
+    return byColor == WHITE ? attackedBy<WHITE>(pos, occupied) : attackedBy<BLACK>(pos, occupied);
+}
 
-    char bishopChar = (byColor == 'w') ? 'B' : 'b';
-    const int dirsBishop[4][2] = {{1,1},{1,-1},{-1,1},{-1,-1}};
-    for (auto &d : dirsBishop) {
-        int r = row + d[0], c = col + d[1];
-        while (r >= 0 && r < 8 && c >= 0 && c < 8) {
-            if (board[r][c] != 0) {
-                if (board[r][c] == bishopChar || board[r][c] == queenChar) return true;
-                break;
-            }
-            r += d[0]; c += d[1];
-        }
-    }
+Bitboard Attack::attackersTo(const Position& pos, int sq, Bitboard occupied) {
+    using namespace AttackTables;
+    Bitboard queens = pos.piecesOf(WHITE, QUEEN) | pos.piecesOf(BLACK, QUEEN);
+
+    return (pawnAttacks(BLACK, sq) & pos.piecesOf(WHITE, PAWN))
+         | (pawnAttacks(WHITE, sq) & pos.piecesOf(BLACK, PAWN))
+         | (knightAttacks(sq) & (pos.piecesOf(WHITE, KNIGHT) | pos.piecesOf(BLACK, KNIGHT)))
+         | (kingAttacks(sq) & (pos.piecesOf(WHITE, KING) | pos.piecesOf(BLACK, KING)))
+         | (bishopAttacks(sq, occupied) & (pos.piecesOf(WHITE, BISHOP) | pos.piecesOf(BLACK, BISHOP) | queens))
+         | (rookAttacks(sq, occupied) & (pos.piecesOf(WHITE, ROOK) | pos.piecesOf(BLACK, ROOK) | queens));
+}
 
-    char kingChar = (byColor == 'w') ? 'K' : 'k';
-    for (int dr = -1; dr <= 1; ++dr) {
-        for (int dc = -1; dc <= 1; ++dc) {
-            if (dr == 0 && dc == 0) continue;
-            int nr = row + dr, nc = col + dc;
-            if (nr >= 0 && nr < 8 && nc >= 0 && nc < 8) {
-                if (board[nr][nc] == kingChar) return true;
-            }
-        }
+Bitboard Attack::sliderBlockers(const Position& pos, int sq, Color by) {
+    Bitboard queens = pos.piecesOf(by, QUEEN);
+    Bitboard snipers = (rookAttacks(sq, 0) & (pos.piecesOf(by, ROOK) | queens))
+                     | (bishopAttacks(sq, 0) & (pos.piecesOf(by, BISHOP) | queens));
+    Bitboard result = 0;
+    while (snipers) {
+        Bitboard blockers = between(sq, Bitboards::popLsb(snipers)) & pos.occupied;
+        if (blockers && !Bitboards::moreThanOne(blockers)) result |= blockers;
     }
-    return false;
+    return result;
 }
 
 // --- Cienkie wrappery klasy Board (zachowujemy istniejący interfejs) ---
@@ -24,23 +24,23 @@ std::string Board::checkCastlingReason(const Move &move) const // -> Dodane MS
     if (!shortSide && !longSide)
         return "To nie jest roszada: zly wektor ruchu.";
 
-    // 1) Prawa do roszady z FEN (KQkq)
-    auto hasRight = [&](char r)
+    // 1) Prawa do roszady (maska CASTLE_*, z FEN "KQkq")
+    auto hasRight = [&](uint8_t r)
     {
-        return castling != "-" && castling.find(r) != std::string::npos;
+        return (state.castling & r) != 0;
     };
     if (white)
     {
-        if (shortSide && !hasRight('K'))
+        if (shortSide && !hasRight(CASTLE_WK))
             return "Brak prawa do krotkiej roszady (krol lub wieza ruszali sie wczesniej).";
-        if (longSide && !hasRight('Q'))
+        if (longSide && !hasRight(CASTLE_WQ))
             return "Brak prawa do dlugiej roszady (krol lub wieza ruszali sie wczesniej).";
     }
     else
     {
-        if (shortSide && !hasRight('k'))
+        if (shortSide && !hasRight(CASTLE_BK))
             return "Brak prawa do krótkiej roszady (krol lub wieza ruszali sie wczesniej).";
-        if (longSide && !hasRight('q'))
+        if (longSide && !hasRight(CASTLE_BQ))
             return "Brak prawa do dlugiej roszady (krol lub wieza ruszali sie wczesniej).";
     }
 
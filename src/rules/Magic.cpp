@@ -0,0 +1,121 @@
+// Magic.cpp
+#include "chess/rules/Magic.h"
+#include <cstdint>
+
+using namespace Bitboards;
+
+namespace Magic {
+    Entry bishopEntries[64];
+    Entry rookEntries[64];
+}
+
+namespace {
+    // Wspólne tablice ataków: suma 2^bity(maski) po wszystkich polach
+    Bitboard bishopTable[0x1480];   // 5248
+    Bitboard rookTable[0x19000];    // 102400
+
+    // Promienie liczone krok po kroku - zatrzymujemy się na pierwszej zajętej bierce (też ją atakujemy)
+    Bitboard slidingAttacks(int sq, Bitboard occupied, const int dirs[4][2]) {
+        Bitboard attacks = 0;
+        for (int i = 0; i < 4; ++i) {
+            int r = rowOf(sq) + dirs[i][0], c = colOf(sq) + dirs[i][1];
+            while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+                Bitboard b = squareBB(square(r, c));
+                attacks |= b;
+                if (occupied & b) break;
+                r += dirs[i][0]; c += dirs[i][1];
+            }
+        }
+        return attacks;
+    }
+
+    const int dirsBishop[4][2] = {{1,1},{1,-1},{-1,1},{-1,-1}};
+    const int dirsRook[4][2]   = {{1,0},{-1,0},{0,1},{0,-1}};
+
+    // xorshift64* ze stałym ziarnem - te same magie przy każdym uruchomieniu
+    class Prng {
+        uint64_t s;
+    public:
+        explicit Prng(uint64_t seed) : s(seed) {}
+        uint64_t next() {
+            s ^= s >> 12; s ^= s << 25; s ^= s >> 27;
+            return s * 2685821657736338717ULL;
+        }
+        uint64_t sparse() { return next() & next() & next(); }  // mało bitów = szybciej znajdujemy magię
+    };
+
+    // Ziarna dobrane tak, by magie dla każdego rzędu znajdowały się szybko (start w kilkadziesiąt ms)
+    constexpr uint64_t SEEDS[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+
+    void initEntries(Magic::Entry entries[64], Bitboard* table, Bitboard (*slow)(int, Bitboard)) {
+        static Bitboard occupancy[4096], reference[4096];
+#if !defined(__BMI2__)
+        // Numer próby, w której zapisano dany indeks - bez czyszczenia tablicy ataków co próbę
+        static int epoch[4096];
+        int attempt = 0;
+        for (int& x : epoch) x = 0;
+#endif
+        Bitboard* next = table;
+
+        for (int sq = 0; sq < 64; ++sq) {
+            // Pola brzegowe nie wpływają na atak (dalej i tak nic nie ma)
+            Bitboard edges = ((rowBB(0) | rowBB(7)) & ~rowBB(rowOf(sq))) |
+                             ((FILE_A | FILE_H) & ~fileBB(colOf(sq)));
+            Magic::Entry& e = entries[sq];
+            e.mask = slow(sq, 0) & ~edges;
+            e.shift = 64 - popCount(e.mask);
+            e.attacks = next;
+
+            // Wszystkie podzbiory maski (Carry-Rippler) i ich ataki referencyjne
+            int size = 0;
+            Bitboard b = 0;
+            do {
+                occupancy[size] = b;
+                reference[size] = slow(sq, b);
+                ++size;
+                b = (b - e.mask) & e.mask;
+            } while (b);
+            next += size;
+
+#if defined(__BMI2__)
+            e.magic = 0;
+            for (int i = 0; i < size; ++i)
+                e.attacks[e.index(occupancy[i])] = reference[i];
+#else
+            // Losuj magie, aż żadne dwa podzbiory o różnych atakach nie trafią w ten sam indeks
+            Prng rng(SEEDS[rowOf(sq)]);
+            for (int i = 0; i < size; ) {
+                do {
+                    e.magic = rng.sparse();
+                } while (popCount((e.magic * e.mask) >> 56) < 6);
+
+                ++attempt;
+                for (i = 0; i < size; ++i) {
+                    unsigned idx = e.index(occupancy[i]);
+                    if (epoch[idx] < attempt) {
+                        epoch[idx] = attempt;
+                        e.attacks[idx] = reference[i];
+                    } else if (e.attacks[idx] != reference[i]) {
+                        break;
+                    }
+                }
+            }
+#endif
+        }
+    }
+
+    struct MagicInit {
+        MagicInit() {
+            initEntries(Magic::bishopEntries, bishopTable, Magic::slowBishopAttacks);
+            initEntries(Magic::rookEntries, rookTable, Magic::slowRookAttacks);
+        }
+    } magicInit;
+}
+
+Bitboard Magic::slowBishopAttacks(int sq, Bitboard occupied) {
+    return slidingAttacks(sq, occupied, dirsBishop);
+}
+
+Bitboard Magic::slowRookAttacks(int sq, Bitboard occupied) {
+    return slidingAttacks(sq, occupied, dirsRook);
+}
@@ -20,60 +20,51 @@ void Board::makeMove(const Move &move)
     bool whiteMoved = std::isupper(moved);
 
     // Domyślnie brak nowego EP; ustawimy tylko po podwójnym ruchu piona.
-    std::string newEnPassant = "-";
-
-    // --- Aktualizacja praw roszady (castling) ---
-    auto dropRight = [&](char r) {
-        if (castling == "-") return;
-        size_t p = castling.find(r);
-        if (p != std::string::npos) {
-            castling.erase(p, 1);
-            if (castling.empty()) castling = "-";
-        }
-    };
+    int8_t newEpSquare = NO_SQUARE;
+
+    // --- Aktualizacja praw roszady (maska CASTLE_*) ---
+    auto dropRight = [&](uint8_t r) { state.castling &= ~r; };
 
     // 1) Poruszył się KRÓL -> tracimy oba prawa tej strony
     if (std::toupper(moved) == 'K') {
-        if (whiteMoved) { dropRight('K'); dropRight('Q'); }
-        else            { dropRight('k'); dropRight('q'); }
+        if (whiteMoved) { dropRight(CASTLE_WK); dropRight(CASTLE_WQ); }
+        else            { dropRight(CASTLE_BK); dropRight(CASTLE_BQ); }
     }
 
     // 2) Poruszyła się WIEŻA ze startowego rogu -> tracimy odpowiednie prawo
     if (moved == 'R') {
-        if (move.fromRow == 7 && move.fromCol == 7) dropRight('K'); // h1
-        if (move.fromRow == 7 && move.fromCol == 0) dropRight('Q'); // a1
+        if (move.fromRow == 7 && move.fromCol == 7) dropRight(CASTLE_WK); // h1
+        if (move.fromRow == 7 && move.fromCol == 0) dropRight(CASTLE_WQ); // a1
     }
     if (moved == 'r') {
-        if (move.fromRow == 0 && move.fromCol == 7) dropRight('k'); // h8
-        if (move.fromRow == 0 && move.fromCol == 0) dropRight('q'); // a8
+        if (move.fromRow == 0 && move.fromCol == 7) dropRight(CASTLE_BK); // h8
+        if (move.fromRow == 0 && move.fromCol == 0) dropRight(CASTLE_BQ); // a8
     }
 
     // 3) Zbicie wieży przeciwnika ze startowego rogu -> oni tracą prawo
     if (captured == 'R') {
-        if (move.toRow == 7 && move.toCol == 7) dropRight('K'); // białe O-O
-        if (move.toRow == 7 && move.toCol == 0) dropRight('Q'); // białe O-O-O
+        if (move.toRow == 7 && move.toCol == 7) dropRight(CASTLE_WK); // białe O-O
+        if (move.toRow == 7 && move.toCol == 0) dropRight(CASTLE_WQ); // białe O-O-O
     }
     if (captured == 'r') {
-        if (move.toRow == 0 && move.toCol == 7) dropRight('k'); // czarne O-O
-        if (move.toRow == 0 && move.toCol == 0) dropRight('q'); // czarne O-O-O
+        if (move.toRow == 0 && move.toCol == 7) dropRight(CASTLE_BK); // czarne O-O
+        if (move.toRow == 0 && move.toCol == 0) dropRight(CASTLE_BQ); // czarne O-O-O
     }
 
     // --- Przypadki specjalne ---
     bool isCastle = (std::toupper(moved) == 'K' && std::abs(move.toCol - move.fromCol) == 2);
     bool isPawn   = (std::toupper(moved) == 'P');
 
-    // En passant: czy to EP? (cel pusty, skos o 1 i enPassant wskazuje na cel)
+    // En passant: czy to EP? (cel pusty, skos o 1 i pole EP wskazuje na cel)
     bool isEnPassantCapture = false;
     int dir = whiteMoved ? -1 : 1;
     if (isPawn) {
         int dr = move.toRow - move.fromRow;
         int dc = move.toCol - move.fromCol;
         int adr = std::abs(dr), adc = std::abs(dc);
-        if (adc == 1 && dr == dir && captured == 0 && enPassant != "-") {
-            int epRow, epCol;
-            if (algToCoord(enPassant, epRow, epCol) && epRow == move.toRow && epCol == move.toCol) {
-                isEnPassantCapture = true;
-            }
+        if (adc == 1 && dr == dir && captured == 0 &&
+            state.epSquare == move.toRow * 8 + move.toCol) {
+            isEnPassantCapture = true;
         }
     }
 
@@ -108,7 +99,7 @@ void Board::makeMove(const Move &move)
         board[move.toRow][move.toCol] = promo;
     }
 
-    // --- Ustawianie enPassant po podwójnym ruchu piona ---
+    // --- Ustawianie pola EP po podwójnym ruchu piona ---
     if (isPawn) {
         // jeśli to był ruch o 2 pola – EP to pole „minięte”
         if ((whiteMoved && move.fromRow == 6 && move.toRow == 4) ||
@@ -116,26 +107,27 @@ void Board::makeMove(const Move &move)
         {
             int passRow = move.fromRow + (whiteMoved ? -1 : 1);
             int passCol = move.fromCol;
-            newEnPassant = coordToAlg(passRow, passCol);
+            newEpSquare = static_cast<int8_t>(passRow * 8 + passCol);
         }
     }
 
-    // --- Liczniki & enPassant ---
+    // --- Liczniki & EP ---
     // 50‑move rule: reset po ruchu pionem lub biciu (także EP), inaczej +1
-    if (isPawn || captured != 0 || isEnPassantCapture) halfmoveClock = 0;
-    else halfmoveClock += 1;
+    if (isPawn || captured != 0 || isEnPassantCapture) state.halfmoveClock = 0;
+    else state.halfmoveClock += 1;
 
-    // enPassant: ustaw nowe (po 2‑polowym ruchu piona), w innym wypadku "-"
-    enPassant = newEnPassant;
+    // EP: ustaw nowe (po 2‑polowym ruchu piona), w innym wypadku brak
+    state.epSquare = newEpSquare;
 
     // fullmoveNumber: po ruchu czarnych zwiększ o 1
     char moverBefore = activeColor;            // kto właśnie się ruszał
     activeColor = (activeColor == 'w') ? 'b' : 'w';
     if (moverBefore == 'b') {
-        fullmoveNumber += 1;
+        state.fullmoveNumber += 1;
     }
 
     // Zapis pozycji po ruchu (dla 3x powtórzenia)
-    gameStateManager.addPosition(board, activeColor, castling, enPassant);
+    syncPosition();
+    gameStateManager.addPosition(position);
 
 }
\ No newline at end of file
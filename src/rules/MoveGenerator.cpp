@@ -1,322 +1,477 @@
 #include "chess/rules/MoveGenerator.h"
-#include <cctype>
-#include <cmath>
 #include "chess/rules/Attack.h"
 
+using namespace Bitboards;
 
-std::vector<Move> MoveGenerator::generateAllMoves(const char board[8][8], char activeColor, 
-                                                 const std::string& castling, const std::string& enPassant) {
-    std::vector<Move> moves;
-    
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            char piece = board[row][col];
-            if (!piece) continue;
-            
-            bool whitePiece = std::isupper(piece);
-            if ((activeColor == 'w' && !whitePiece) || (activeColor == 'b' && whitePiece))
-                continue;
-            
-            switch (std::toupper(piece)) {
-                case 'P':
-                    generatePawnMoves(board, row, col, activeColor, enPassant, moves);
-                    break;
-                case 'N':
-                    generateKnightMoves(board, row, col, activeColor, moves);
-                    break;
-                case 'B':
-                    generateBishopMoves(board, row, col, activeColor, moves);
-                    break;
-                case 'R':
-                    generateRookMoves(board, row, col, activeColor, moves);
-                    break;
-                case 'Q':
-                    generateQueenMoves(board, row, col, activeColor, moves);
-                    break;
-                case 'K':
-                    generateKingMoves(board, row, col, activeColor, castling, moves);
-                    break;
-            }
+namespace {
+    inline void addMove(const Position& pos, int from, int to, MoveList& moves, char promotion = 0) {
+        moves.push_back({rowOf(from), colOf(from), rowOf(to), colOf(to),
+                         pos.pieceAt(from), pos.pieceAt(to), promotion});
+    }
+
+    inline void addPromotions(const Position& pos, int from, int to, MoveList& moves) {
+        addMove(pos, from, to, moves, 'Q'); // Hetman
+        addMove(pos, from, to, moves, 'R'); // Wieża
+        addMove(pos, from, to, moves, 'B'); // Goniec
+        addMove(pos, from, to, moves, 'N'); // Skoczek
+    }
+
+    inline Position makePosition(const char board[8][8], char activeColor, const PositionState& state) {
+        Position pos(board);
+        pos.setState(toColor(activeColor), state);
+        return pos;
+    }
+
+    // Bicie (także w przelocie - cel pusty, ruch piona po skosie) albo promocja
+    inline bool isCaptureOrPromotion(const Move& m) {
+        return m.capturedPiece || m.promotion ||
+               (typeOf(pieceIndex(m.movedPiece)) == PAWN && m.fromCol != m.toCol);
+    }
+
+    inline Bitboard pieceAttacks(PieceType pt, int sq, Bitboard occupied) {
+        switch (pt) {
+            case KNIGHT: return AttackTables::knightAttacks(sq);
+            case BISHOP: return Attack::bishopAttacks(sq, occupied);
+            case ROOK:   return Attack::rookAttacks(sq, occupied);
+            default:     return Attack::queenAttacks(sq, occupied);
         }
     }
-    
-    return moves;
-}
 
-std::vector<Move> MoveGenerator::generateLegalMoves(const char board[8][8], char activeColor, 
-                                                   const std::string& castling, const std::string& enPassant) {
-    std::vector<Move> allMoves = generateAllMoves(board, activeColor, castling, enPassant);
-    std::vector<Move> legalMoves;
-    
-    for (const Move& move : allMoves) {
-        if (!wouldKingBeInCheck(board, move, activeColor)) {
-            legalMoves.push_back(move);
+    // Wszystkie pola docelowe podanych pionów (bez EP) - zbiorczo, bez listy ruchów
+    template <Color Us>
+    inline Bitboard pawnDestinations(const Position& pos, Bitboard pawns) {
+        constexpr Bitboard doubleRow = (Us == WHITE) ? rowBB(4) : rowBB(3);
+        Bitboard ahead  = (Us == WHITE) ? north(pawns) : south(pawns);
+        Bitboard empty  = ~pos.occupied;
+        Bitboard single = ahead & empty;
+        Bitboard dbl    = ((Us == WHITE) ? north(single) : south(single)) & empty & doubleRow;
+        return single | dbl | ((west(ahead) | east(ahead)) & pos.colors[~Us]);
+    }
+
+    // Piony, które mogą bić w przelocie; legal = odrzuć te, po których bicie odsłania się król
+    // (z planszy znikają dwa piony naraz - także związanie po linii poziomej)
+    template <Color Us>
+    inline Bitboard enPassantAttackers(const Position& pos, Bitboard targets, bool legal) {
+        constexpr Color Them = ~Us;
+        int ep = pos.state.epSquare;
+        if (ep == NO_SQUARE) return 0;
+
+        // Zbijany pion stoi za polem EP (od strony przeciwnika)
+        int capSq = ep + ((Us == WHITE) ? 8 : -8);
+        if (!(targets & (squareBB(ep) | squareBB(capSq)))) return 0;   // nie broni przed szachem
+
+        Bitboard attackers = AttackTables::pawnAttacks(Them, ep) & pos.piecesOf(Us, PAWN);
+        int kingSq = pos.kingSquare(Us);
+        if (!legal || kingSq == NO_SQUARE) return attackers;
+
+        Bitboard queens = pos.piecesOf(Them, QUEEN);
+        Bitboard rooks = pos.piecesOf(Them, ROOK) | queens;
+        Bitboard bishops = pos.piecesOf(Them, BISHOP) | queens;
+        Bitboard result = 0;
+        for (Bitboard b = attackers; b; ) {
+            int from = popLsb(b);
+            Bitboard occ = (pos.occupied ^ squareBB(from) ^ squareBB(capSq)) | squareBB(ep);
+            if (!(Attack::rookAttacks(kingSq, occ) & rooks) && !(Attack::bishopAttacks(kingSq, occ) & bishops))
+                result |= squareBB(from);
         }
+        return result;
     }
-    
-    return legalMoves;
 }
 
-bool MoveGenerator::hasLegalMoves(const char board[8][8], char activeColor, 
-                                 const std::string& castling, const std::string& enPassant) {
-    std::vector<Move> allMoves = generateAllMoves(board, activeColor, castling, enPassant);
-    
-    for (const Move& move : allMoves) {
-        if (!wouldKingBeInCheck(board, move, activeColor)) {
-            return true;
-        }
+
+void MoveGenerator::generateAllMoves(const Position& pos, MoveList& moves) {
+    if (pos.sideToMove == WHITE) generateAll<WHITE>(pos, moves);
+    else                         generateAll<BLACK>(pos, moves);
+}
+
+void MoveGenerator::generateLegalMoves(const Position& pos, MoveList& moves, GenType type) {
+    if (pos.sideToMove == WHITE) generateLegal<WHITE>(pos, moves, type);
+    else                         generateLegal<BLACK>(pos, moves, type);
+}
+
+template <Color Us>
+void MoveGenerator::generateAll(const Position& pos, MoveList& moves) {
+    moves.clear();
+    Bitboard targets = ~pos.colors[Us];
+
+    generatePawnMoves<Us>(pos, pos.piecesOf(Us, PAWN), targets, GenType::ALL, moves);
+    generateEnPassant<Us>(pos, targets, false, moves);
+    for (PieceType pt : {KNIGHT, BISHOP, ROOK, QUEEN}) {
+        generatePieceMoves(pos, pt, pos.piecesOf(Us, pt), targets, moves);
     }
-    
-    return false;
+    generateKingMoves<Us>(pos, GenType::ALL, castlingDanger<Us>(pos), false, moves);
 }
 
-bool MoveGenerator::isInCheck(const char board[8][8], char activeColor) {
-    char kingChar = (activeColor == 'w') ? 'K' : 'k';
-    int kingRow = -1, kingCol = -1;
-    
-    for (int r = 0; r < 8; r++) {
-        for (int c = 0; c < 8; c++) {
-            if (board[r][c] == kingChar) {
-                kingRow = r;
-                kingCol = c;
-                break;
-            }
+template <Color Us>
+MoveGenerator::LegalContext MoveGenerator::legalContext(const Position& pos, int kingSq) {
+    constexpr Color Them = ~Us;
+    LegalContext ctx;
+    // Jedna mapa ataków przeciwnika (król zdjęty z planszy, by nie zasłaniał promienia za sobą):
+    // z niej pola ucieczki króla, roszada i test szachu; szachujących szukamy tylko przy szachu
+    ctx.danger = Attack::attackedBy<Them>(pos, pos.occupied ^ squareBB(kingSq));
+    ctx.checkers = (ctx.danger & squareBB(kingSq))
+                 ? Attack::attackersTo(pos, kingSq, pos.occupied) & pos.colors[Them] : 0;
+    // Maska obrony: przy szachu bij szachującego albo zasłoń linię, inaczej dowolne pole
+    ctx.checkMask = ctx.checkers ? Attack::between(kingSq, lsb(ctx.checkers)) | ctx.checkers : ~Bitboard(0);
+    // Bierki związane: jedyna nasza bierka między królem a wrogą figurą dalekosiężną
+    ctx.pinned = Attack::sliderBlockers(pos, kingSq, Them) & pos.colors[Us];
+    return ctx;
+}
+
+template <Color Us>
+void MoveGenerator::generateLegal(const Position& pos, MoveList& moves, GenType type) {
+    constexpr Color Them = ~Us;
+    int kingSq = pos.kingSquare(Us);
+    if (kingSq == NO_SQUARE) {            // pozycja bez króla - nie ma czego chronić
+        generateAll<Us>(pos, moves);
+        if (type == GenType::ALL) return;
+        int kept = 0;
+        for (const Move& m : moves) {
+            bool tactical = isCaptureOrPromotion(m);
+            if ((type == GenType::CAPTURES && tactical) || (type == GenType::QUIETS && !tactical))
+                moves[kept++] = m;
         }
-        if (kingRow != -1) break;
+        moves.resize(kept);
+        return;
     }
-    
-    if (kingRow == -1) return false;
-    
-    char enemyColor = (activeColor == 'w') ? 'b' : 'w';
-    return Attack::isSquareAttacked(board, kingRow, kingCol, enemyColor);
-}
 
-bool MoveGenerator::wouldKingBeInCheck(const char board[8][8], const Move& move, char activeColor) {
-    // skopiuj planszę
-    char tmp[8][8];
-    for (int r = 0; r < 8; ++r)
-        for (int c = 0; c < 8; ++c)
-            tmp[r][c] = board[r][c];
-
-    char piece = board[move.fromRow][move.fromCol];
-    bool isPawn  = std::toupper(piece) == 'P';
-    bool isKing  = std::toupper(piece) == 'K';
-
-    // --- 1) En passant: usuń pionka bitego z pola "obok" (na rzędzie startowym bijącego) ---
-    bool epCapture = isPawn
-                  && move.fromCol != move.toCol           // ruch po skosie
-                  && board[move.toRow][move.toCol] == 0;  // pole docelowe puste => to musi być EP
-    if (epCapture) {
-        int capRow = move.fromRow;        // pion bity stoi na rzędzie bijącego
-        int capCol = move.toCol;          // w kolumnie pola docelowego
-        tmp[capRow][capCol] = 0;          // zdejmij pion bity EP
+    moves.clear();
+    LegalContext ctx = legalContext<Us>(pos, kingSq);
+    if (type == GenType::EVASIONS && !ctx.checkers) return;
+
+    // Król zawsze; przy podwójnym szachu tylko on może się ruszyć
+    generateKingMoves<Us>(pos, type, ctx.danger, true, moves);
+    if (moreThanOne(ctx.checkers)) return;
+
+    Bitboard targets = ~pos.colors[Us] & ctx.checkMask;
+    Bitboard pieceTargets = targets & (type == GenType::CAPTURES ? pos.colors[Them]
+                                     : type == GenType::QUIETS   ? ~pos.occupied
+                                                                 : ~Bitboard(0));
+
+    // Niezwiązane bierki - zbiorczo; związane - tylko wzdłuż linii związania
+    Bitboard pinned = ctx.pinned;
+    Bitboard pawns = pos.piecesOf(Us, PAWN);
+    generatePawnMoves<Us>(pos, pawns & ~pinned, targets, type, moves);
+    for (Bitboard b = pawns & pinned; b; ) {
+        int from = popLsb(b);
+        generatePawnMoves<Us>(pos, squareBB(from), targets & Attack::line(kingSq, from), type, moves);
     }
+    if (type != GenType::QUIETS) generateEnPassant<Us>(pos, ctx.checkMask, true, moves);
 
-    // --- 2) Roszada: przestaw też wieżę w symulacji (żeby nie fałszować ataków po linii) ---
-    bool castling = isKing && std::abs(move.toCol - move.fromCol) == 2 && move.toRow == move.fromRow;
-    if (castling) {
-        int r = move.fromRow;
-        if (move.toCol == 6) {          // O-O
-            tmp[r][5] = tmp[r][7];
-            tmp[r][7] = 0;
-        } else if (move.toCol == 2) {   // O-O-O
-            tmp[r][3] = tmp[r][0];
-            tmp[r][0] = 0;
+    for (PieceType pt : {KNIGHT, BISHOP, ROOK, QUEEN}) {
+        Bitboard pieces = pos.piecesOf(Us, pt);
+        generatePieceMoves(pos, pt, pieces & ~pinned, pieceTargets, moves);
+        if (pt == KNIGHT) continue;   // związany skoczek nie ma ruchów
+        for (Bitboard b = pieces & pinned; b; ) {
+            int from = popLsb(b);
+            generatePieceMoves(pos, pt, squareBB(from), pieceTargets & Attack::line(kingSq, from), moves);
         }
     }
+}
 
-    // --- 3) Wykonaj ruch figury na planszy tymczasowej ---
-    tmp[move.toRow][move.toCol]   = tmp[move.fromRow][move.fromCol];
-    tmp[move.fromRow][move.fromCol] = 0;
+void MoveGenerator::generateCaptures(const Position& pos, MoveList& moves) {
+    generateLegalMoves(pos, moves, GenType::CAPTURES);
+}
 
-    // --- 4) Sprawdź, czy nasz król jest w szachu po ruchu ---
-    return isInCheck(tmp, activeColor);
+void MoveGenerator::generateQuiets(const Position& pos, MoveList& moves) {
+    generateLegalMoves(pos, moves, GenType::QUIETS);
 }
 
+void MoveGenerator::generateEvasions(const Position& pos, MoveList& moves) {
+    generateLegalMoves(pos, moves, GenType::EVASIONS);
+}
 
+std::vector<Move> MoveGenerator::generateAllMoves(const Position& pos) {
+    MoveList moves;
+    generateAllMoves(pos, moves);
+    return moves.toVector();
+}
 
+std::vector<Move> MoveGenerator::generateLegalMoves(const Position& pos) {
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    return moves.toVector();
+}
 
+bool MoveGenerator::hasLegalMoves(const Position& pos) {
+    return pos.sideToMove == WHITE ? anyLegalMove<WHITE>(pos) : anyLegalMove<BLACK>(pos);
+}
 
-void MoveGenerator::generatePawnMoves(const char board[8][8], int row, int col, char activeColor, 
-                                     const std::string& enPassant, std::vector<Move>& moves) {
-    char piece = board[row][col];
-    bool whitePiece = std::isupper(piece);
-    int dir = whitePiece ? -1 : 1;
-    int startRow = whitePiece ? 6 : 1;
-    
-    if (row + dir >= 0 && row + dir < 8 && board[row + dir][col] == 0) {
-        // Sprawdź czy to promocja
-        if ((whitePiece && row + dir == 0) || (!whitePiece && row + dir == 7)) {
-            // Generuj ruchy z promocją do wszystkich figur
-            moves.push_back({row, col, row + dir, col, piece, 0, 'Q'}); // Hetman
-            moves.push_back({row, col, row + dir, col, piece, 0, 'R'}); // Wieża
-            moves.push_back({row, col, row + dir, col, piece, 0, 'B'}); // Goniec
-            moves.push_back({row, col, row + dir, col, piece, 0, 'N'}); // Skoczek
-        } else {
-            moves.push_back({row, col, row + dir, col, piece, 0});
-        }
-        
-        if (row == startRow && board[row + 2*dir][col] == 0) {
-            moves.push_back({row, col, row + 2*dir, col, piece, 0});
-        }
+template <Color Us>
+bool MoveGenerator::anyLegalMove(const Position& pos) {
+    int kingSq = pos.kingSquare(Us);
+    if (kingSq == NO_SQUARE) {
+        MoveList moves;
+        generateAll<Us>(pos, moves);
+        return !moves.empty();
     }
-    
-    for (int dc = -1; dc <= 1; dc += 2) {
-        if (col + dc >= 0 && col + dc < 8 && row + dir >= 0 && row + dir < 8) {
-            char target = board[row + dir][col + dc];
-            if (target && (std::isupper(target) != whitePiece)) {
-                // Sprawdź czy to promocja
-                if ((whitePiece && row + dir == 0) || (!whitePiece && row + dir == 7)) {
-                    // Generuj ruchy z promocją do wszystkich figur
-                    moves.push_back({row, col, row + dir, col + dc, piece, target, 'Q'}); // Hetman
-                    moves.push_back({row, col, row + dir, col + dc, piece, target, 'R'}); // Wieża
-                    moves.push_back({row, col, row + dir, col + dc, piece, target, 'B'}); // Goniec
-                    moves.push_back({row, col, row + dir, col + dc, piece, target, 'N'}); // Skoczek
-                } else {
-                    moves.push_back({row, col, row + dir, col + dc, piece, target});
-                }
-            }
+
+    // Najpierw król (roszady nie trzeba sprawdzać - gdy jest legalna, legalny jest też
+    // krok na pole obok), przy podwójnym szachu tylko on
+    LegalContext ctx = legalContext<Us>(pos, kingSq);
+    Bitboard own = pos.colors[Us];
+    if (AttackTables::kingAttacks(kingSq) & ~own & ~ctx.danger) return true;
+    if (moreThanOne(ctx.checkers)) return false;
+    Bitboard targets = ~own & ctx.checkMask;
+    Bitboard pinned = ctx.pinned;
+
+    // Potem bierka po bierce - pierwsze pole docelowe w masce kończy szukanie
+    for (PieceType pt : {KNIGHT, BISHOP, ROOK, QUEEN}) {
+        for (Bitboard b = pos.piecesOf(Us, pt); b; ) {
+            int from = popLsb(b);
+            Bitboard mask = (pinned & squareBB(from)) ? targets & Attack::line(kingSq, from) : targets;
+            if (pieceAttacks(pt, from, pos.occupied) & mask) return true;
         }
     }
-    
-    if (enPassant != "-" && enPassant.length() >= 2) {
-        int epCol = enPassant[0] - 'a';
-        int epRow = '8' - enPassant[1];
-        if (std::abs(col - epCol) == 1 && row + dir == epRow) {
-            moves.push_back({row, col, epRow, epCol, piece, 0});
-        }
+
+    Bitboard pawns = pos.piecesOf(Us, PAWN);
+    if (pawnDestinations<Us>(pos, pawns & ~pinned) & targets) return true;
+    for (Bitboard b = pawns & pinned; b; ) {
+        int from = popLsb(b);
+        if (pawnDestinations<Us>(pos, squareBB(from)) & targets & Attack::line(kingSq, from)) return true;
     }
+    return enPassantAttackers<Us>(pos, ctx.checkMask, true) != 0;
 }
 
-void MoveGenerator::generateKnightMoves(const char board[8][8], int row, int col, char activeColor, std::vector<Move>& moves) {
-    char piece = board[row][col];
-    bool whitePiece = std::isupper(piece);
-    
-    const int knightMoves[8][2] = {{-2,-1},{-2,1},{-1,-2},{-1,2},
-                                   {1,-2},{1,2},{2,-1},{2,1}};
-    
-    for (auto& m : knightMoves) {
-        int newRow = row + m[0];
-        int newCol = col + m[1];
-        
-        if (newRow >= 0 && newRow < 8 && newCol >= 0 && newCol < 8) {
-            char target = board[newRow][newCol];
-            if (!target || (std::isupper(target) != whitePiece)) {
-                moves.push_back({row, col, newRow, newCol, piece, target});
-            }
-        }
+bool MoveGenerator::isInCheck(const Position& pos) {
+    return pos.sideToMove == WHITE ? inCheck<WHITE>(pos) : inCheck<BLACK>(pos);
+}
+
+template <Color Us>
+bool MoveGenerator::inCheck(const Position& pos) {
+    int kingSq = pos.kingSquare(Us);
+    if (kingSq == NO_SQUARE) return false;
+    return Attack::isSquareAttacked<~Us>(pos, kingSq);
+}
+
+bool MoveGenerator::isPseudoLegal(const Position& pos, const Move& move) {
+    if (move.fromRow < 0 || move.fromRow > 7 || move.fromCol < 0 || move.fromCol > 7 ||
+        move.toRow < 0 || move.toRow > 7 || move.toCol < 0 || move.toCol > 7) return false;
+
+    Color us = pos.sideToMove;
+    int from = square(move.fromRow, move.fromCol);
+    int idx = pieceIndex(pos.pieceAt(from));
+    if (idx == NO_PIECE || colorOf(idx) != us) return false;
+
+    // Ruchy tylko tej jednej bierki - dużo taniej niż pełna generacja
+    MoveList moves;
+    if (us == WHITE) generatePieceFrom<WHITE>(pos, from, moves);
+    else             generatePieceFrom<BLACK>(pos, from, moves);
+
+    for (const Move& m : moves) {
+        if (m.fromRow == move.fromRow && m.fromCol == move.fromCol &&
+            m.toRow == move.toRow && m.toCol == move.toCol && m.promotion == move.promotion)
+            return true;
     }
+    return false;
 }
 
-void MoveGenerator::generateBishopMoves(const char board[8][8], int row, int col, char activeColor, std::vector<Move>& moves) {
-    char piece = board[row][col];
-    bool whitePiece = std::isupper(piece);
-    
-    const int directions[4][2] = {{1,1},{1,-1},{-1,1},{-1,-1}};
-    
-    for (auto& dir : directions) {
-        for (int i = 1; i < 8; i++) {
-            int newRow = row + dir[0] * i;
-            int newCol = col + dir[1] * i;
-            
-            if (newRow < 0 || newRow >= 8 || newCol < 0 || newCol >= 8) break;
-            
-            char target = board[newRow][newCol];
-            if (!target) {
-                moves.push_back({row, col, newRow, newCol, piece, 0});
-            } else {
-                if (std::isupper(target) != whitePiece) {
-                    moves.push_back({row, col, newRow, newCol, piece, target});
-                }
-                break;
-            }
-        }
+template <Color Us>
+void MoveGenerator::generatePieceFrom(const Position& pos, int from, MoveList& moves) {
+    Bitboard targets = ~pos.colors[Us];
+    PieceType pt = typeOf(pieceIndex(pos.pieceAt(from)));
+    if (pt == PAWN) {
+        generatePawnMoves<Us>(pos, squareBB(from), targets, GenType::ALL, moves);
+        generateEnPassant<Us>(pos, targets, false, moves);
+    } else if (pt == KING) {
+        generateKingMoves<Us>(pos, GenType::ALL, castlingDanger<Us>(pos), false, moves);
+    } else {
+        generatePieceMoves(pos, pt, squareBB(from), targets, moves);
     }
 }
 
-void MoveGenerator::generateRookMoves(const char board[8][8], int row, int col, char activeColor, std::vector<Move>& moves) {
-    char piece = board[row][col];
-    bool whitePiece = std::isupper(piece);
-    
-    const int directions[4][2] = {{1,0},{-1,0},{0,1},{0,-1}};
-    
-    for (auto& dir : directions) {
-        for (int i = 1; i < 8; i++) {
-            int newRow = row + dir[0] * i;
-            int newCol = col + dir[1] * i;
-            
-            if (newRow < 0 || newRow >= 8 || newCol < 0 || newCol >= 8) break;
-            
-            char target = board[newRow][newCol];
-            if (!target) {
-                moves.push_back({row, col, newRow, newCol, piece, 0});
-            } else {
-                if (std::isupper(target) != whitePiece) {
-                    moves.push_back({row, col, newRow, newCol, piece, target});
-                }
-                break;
-            }
-        }
+bool MoveGenerator::isLegal(const Position& pos, const Move& move) {
+    Color us = pos.sideToMove, them = ~us;
+    int kingSq = pos.kingSquare(us);
+    if (kingSq == NO_SQUARE) return true;
+
+    int from = square(move.fromRow, move.fromCol);
+    int to   = square(move.toRow, move.toCol);
+    PieceType pt = typeOf(pieceIndex(pos.pieceAt(from)));
+
+    if (pt == KING) {
+        if (move.toCol - move.fromCol == 2 || move.fromCol - move.toCol == 2) return true;  // roszada sprawdzona w generatorze
+        return !(Attack::attackersTo(pos, to, pos.occupied ^ squareBB(from)) & pos.colors[them]);
     }
+
+    // Zajętość po ruchu (przy EP znika pion obok pola docelowego); zbita bierka już nie atakuje
+    Bitboard captured = squareBB(to);
+    if (pt == PAWN && to == pos.state.epSquare && move.fromCol != move.toCol)
+        captured = squareBB(to + ((us == WHITE) ? 8 : -8));
+    Bitboard occ = ((pos.occupied ^ squareBB(from)) & ~captured) | squareBB(to);
+    return !(Attack::attackersTo(pos, kingSq, occ) & pos.colors[them] & ~captured);
 }
 
-void MoveGenerator::generateQueenMoves(const char board[8][8], int row, int col, char activeColor, std::vector<Move>& moves) {
-    generateBishopMoves(board, row, col, activeColor, moves);
-    generateRookMoves(board, row, col, activeColor, moves);
+CheckInfo::CheckInfo(const Position& pos) {
+    Color us = pos.sideToMove, them = ~us;
+    kingSq = pos.kingSquare(them);
+    if (kingSq == NO_SQUARE) return;
+
+    checkSquares[PAWN]   = AttackTables::pawnAttacks(them, kingSq);
+    checkSquares[KNIGHT] = AttackTables::knightAttacks(kingSq);
+    checkSquares[BISHOP] = Attack::bishopAttacks(kingSq, pos.occupied);
+    checkSquares[ROOK]   = Attack::rookAttacks(kingSq, pos.occupied);
+    checkSquares[QUEEN]  = checkSquares[BISHOP] | checkSquares[ROOK];
+
+    // Nasze bierki jako jedyne między królem przeciwnika a naszą figurą dalekosiężną
+    discoverers = Attack::sliderBlockers(pos, kingSq, us) & pos.colors[us];
 }
 
-void MoveGenerator::generateKingMoves(const char board[8][8], int row, int col, char activeColor, 
-                                     const std::string& castling, std::vector<Move>& moves) {
-    char piece = board[row][col];
-    bool whitePiece = std::isupper(piece);
-    
-    for (int dr = -1; dr <= 1; dr++) {
-        for (int dc = -1; dc <= 1; dc++) {
-            if (dr == 0 && dc == 0) continue;
-            
-            int newRow = row + dr;
-            int newCol = col + dc;
-            
-            if (newRow >= 0 && newRow < 8 && newCol >= 0 && newCol < 8) {
-                char target = board[newRow][newCol];
-                if (!target || (std::isupper(target) != whitePiece)) {
-                    moves.push_back({row, col, newRow, newCol, piece, target});
-                }
-            }
-        }
+bool MoveGenerator::givesCheck(const Position& pos, const Move& move) {
+    return givesCheck(pos, move, CheckInfo(pos));
+}
+
+bool MoveGenerator::givesCheck(const Position& pos, const Move& move, const CheckInfo& ci) {
+    if (ci.kingSq == NO_SQUARE) return false;
+
+    Color us = pos.sideToMove;
+    int from = square(move.fromRow, move.fromCol);
+    int to   = square(move.toRow, move.toCol);
+    PieceType pt = typeOf(pieceIndex(move.movedPiece));
+    Bitboard kingBB = squareBB(ci.kingSq);
+
+    // Szach bezpośredni (pion z promocją liczony niżej jako nowa figura)
+    if (!move.promotion && (ci.checkSquares[pt] & squareBB(to))) return true;
+
+    // Szach odsłonięty: bierka schodzi z linii między naszą figurą a królem
+    if ((ci.discoverers & squareBB(from)) && !(Attack::line(from, ci.kingSq) & squareBB(to))) return true;
+
+    Bitboard occ = pos.occupied ^ squareBB(from);
+    if (move.promotion) {
+        PieceType promo = typeOf(pieceIndex(move.promotion));
+        return pieceAttacks(promo, to, occ) & kingBB;
     }
-    
-    if (whitePiece && row == 7 && col == 4) {
-        if (castling.find('K') != std::string::npos && 
-            board[7][5] == 0 && board[7][6] == 0 && board[7][7] == 'R' &&
-            !Attack::isSquareAttacked(board, 7, 4, 'b') &&
-            !Attack::isSquareAttacked(board, 7, 5, 'b') &&
-            !Attack::isSquareAttacked(board, 7, 6, 'b')) {
-            moves.push_back({7, 4, 7, 6, 'K', 0});
-        }
-        if (castling.find('Q') != std::string::npos && 
-            board[7][3] == 0 && board[7][2] == 0 && board[7][1] == 0 && board[7][0] == 'R' &&
-            !Attack::isSquareAttacked(board, 7, 4, 'b') &&
-            !Attack::isSquareAttacked(board, 7, 3, 'b') &&
-            !Attack::isSquareAttacked(board, 7, 2, 'b')) {
-            moves.push_back({7, 4, 7, 2, 'K', 0});
-        }
+
+    // Bicie w przelocie: znikają dwa piony - możliwe odsłonięcie po linii, której nie ma w discoverers
+    if (pt == PAWN && move.fromCol != move.toCol && !move.capturedPiece) {
+        int capSq = to + ((us == WHITE) ? 8 : -8);
+        Bitboard after = (occ ^ squareBB(capSq)) | squareBB(to);
+        Bitboard queens = pos.piecesOf(us, QUEEN);
+        return (Attack::rookAttacks(ci.kingSq, after) & (pos.piecesOf(us, ROOK) | queens)) ||
+               (Attack::bishopAttacks(ci.kingSq, after) & (pos.piecesOf(us, BISHOP) | queens));
     }
-    
-    if (!whitePiece && row == 0 && col == 4) {
-        if (castling.find('k') != std::string::npos && 
-            board[0][5] == 0 && board[0][6] == 0 && board[0][7] == 'r' &&
-            !Attack::isSquareAttacked(board, 0, 4, 'w') &&
-            !Attack::isSquareAttacked(board, 0, 5, 'w') &&
-            !Attack::isSquareAttacked(board, 0, 6, 'w')) {
-            moves.push_back({0, 4, 0, 6, 'k', 0});
-        }
-        if (castling.find('q') != std::string::npos && 
-            board[0][3] == 0 && board[0][2] == 0 && board[0][1] == 0 && board[0][0] == 'r' &&
-            !Attack::isSquareAttacked(board, 0, 4, 'w') &&
-            !Attack::isSquareAttacked(board, 0, 3, 'w') &&
-            !Attack::isSquareAttacked(board, 0, 2, 'w')) {
-            moves.push_back({0, 4, 0, 2, 'k', 0});
+
+    // Roszada: szachować może tylko wieża na nowym polu
+    if (pt == KING && (move.toCol - move.fromCol == 2 || move.fromCol - move.toCol == 2)) {
+        bool kingSide = move.toCol > move.fromCol;
+        int rookFrom = square(move.fromRow, kingSide ? 7 : 0);
+        int rookTo   = square(move.fromRow, kingSide ? 5 : 3);
+        Bitboard after = (occ ^ squareBB(rookFrom)) | squareBB(to) | squareBB(rookTo);
+        return Attack::rookAttacks(rookTo, after) & kingBB;
+    }
+    return false;
+}
+
+// --- Wersje na tablicy 8x8 ---
+std::vector<Move> MoveGenerator::generateAllMoves(const char board[8][8], char activeColor,
+                                                 const PositionState& state) {
+    return generateAllMoves(makePosition(board, activeColor, state));
+}
+
+std::vector<Move> MoveGenerator::generateLegalMoves(const char board[8][8], char activeColor,
+                                                   const PositionState& state) {
+    return generateLegalMoves(makePosition(board, activeColor, state));
+}
+
+bool MoveGenerator::hasLegalMoves(const char board[8][8], char activeColor,
+                                 const PositionState& state) {
+    return hasLegalMoves(makePosition(board, activeColor, state));
+}
+
+bool MoveGenerator::isInCheck(const char board[8][8], char activeColor) {
+    return isInCheck(makePosition(board, activeColor, PositionState{0, NO_SQUARE, 0, 1}));
+}
+
+
+template <Color Us>
+void MoveGenerator::generatePawnMoves(const Position& pos, Bitboard pawns, Bitboard targets,
+                                      GenType type, MoveList& moves) {
+    constexpr int up = (Us == WHITE) ? -8 : 8;
+    constexpr Bitboard promoRow  = (Us == WHITE) ? rowBB(0) : rowBB(7);
+    constexpr Bitboard doubleRow = (Us == WHITE) ? rowBB(4) : rowBB(3);
+    auto forward = [](Bitboard b) { return Us == WHITE ? north(b) : south(b); };
+
+    Bitboard empty   = ~pos.occupied;
+    Bitboard enemies = pos.colors[~Us] & targets;
+
+    // Ruchy do przodu o 1 i o 2 (pole pośrednie musi być puste, cel - w masce)
+    Bitboard single = forward(pawns) & empty;
+    Bitboard dbl    = forward(single) & empty & doubleRow & targets;
+    single &= targets;
+    if (type != GenType::CAPTURES) {
+        for (Bitboard b = single & ~promoRow; b; ) { int to = popLsb(b); addMove(pos, to - up, to, moves); }
+        for (Bitboard b = dbl; b; )                { int to = popLsb(b); addMove(pos, to - 2 * up, to, moves); }
+    }
+    if (type == GenType::QUIETS) return;   // promocje (także bez bicia) należą do bić
+
+    for (Bitboard b = single & promoRow; b; )  { int to = popLsb(b); addPromotions(pos, to - up, to, moves); }
+
+    // Bicia po skosie (w stronę kolumny a i kolumny h)
+    Bitboard capWest = west(forward(pawns)) & enemies;
+    Bitboard capEast = east(forward(pawns)) & enemies;
+    for (Bitboard b = capWest & ~promoRow; b; ) { int to = popLsb(b); addMove(pos, to - up + 1, to, moves); }
+    for (Bitboard b = capWest & promoRow; b; )  { int to = popLsb(b); addPromotions(pos, to - up + 1, to, moves); }
+    for (Bitboard b = capEast & ~promoRow; b; ) { int to = popLsb(b); addMove(pos, to - up - 1, to, moves); }
+    for (Bitboard b = capEast & promoRow; b; )  { int to = popLsb(b); addPromotions(pos, to - up - 1, to, moves); }
+}
+
+template <Color Us>
+void MoveGenerator::generateEnPassant(const Position& pos, Bitboard targets, bool legal, MoveList& moves) {
+    for (Bitboard b = enPassantAttackers<Us>(pos, targets, legal); b; ) {
+        addMove(pos, popLsb(b), pos.state.epSquare, moves);
+    }
+}
+
+void MoveGenerator::generatePieceMoves(const Position& pos, PieceType pt, Bitboard pieces, Bitboard targets,
+                                       MoveList& moves) {
+    while (pieces) {
+        int from = popLsb(pieces);
+        for (Bitboard t = pieceAttacks(pt, from, pos.occupied) & targets; t; ) {
+            addMove(pos, from, popLsb(t), moves);
         }
     }
-}
\ No newline at end of file
+}
+
+template <Color Us>
+Bitboard MoveGenerator::castlingDanger(const Position& pos) {
+    constexpr uint8_t rights = (Us == WHITE) ? (CASTLE_WK | CASTLE_WQ) : (CASTLE_BK | CASTLE_BQ);
+    return (pos.state.castling & rights) ? Attack::attackedBy<~Us>(pos, pos.occupied) : 0;
+}
+
+template <Color Us>
+void MoveGenerator::generateKingMoves(const Position& pos, GenType type, Bitboard danger, bool legal,
+                                      MoveList& moves) {
+    constexpr Color Them = ~Us;
+    // Pola i prawa roszady strony Us: rząd bazowy, wieża, król-/hetmanowe skrzydło
+    constexpr int home = (Us == WHITE) ? 7 : 0;
+    constexpr char rook = (Us == WHITE) ? 'R' : 'r';
+    constexpr uint8_t kingSide  = (Us == WHITE) ? CASTLE_WK : CASTLE_BK;
+    constexpr uint8_t queenSide = (Us == WHITE) ? CASTLE_WQ : CASTLE_BQ;
+
+    int from = pos.kingSquare(Us);
+    if (from == NO_SQUARE) return;
+
+    Bitboard targets = type == GenType::CAPTURES ? pos.colors[Them]
+                     : type == GenType::QUIETS   ? ~pos.occupied
+                                                 : ~pos.colors[Us];
+    if (legal) targets &= ~danger;
+    for (Bitboard t = AttackTables::kingAttacks(from) & targets; t; ) {
+        addMove(pos, from, popLsb(t), moves);
+    }
+
+    // Roszada: pola między królem a wieżą puste, pola króla (start, przejście, cel) nieatakowane.
+    // Mapa liczona bez króla wystarcza - atak "przez" króla oznacza szach, a wtedy roszady nie ma.
+    if (type == GenType::CAPTURES || from != square(home, 4) || (danger & squareBB(from))) return;
+    constexpr Bitboard kingEmpty  = squareBB(square(home, 5)) | squareBB(square(home, 6));
+    constexpr Bitboard queenEmpty = squareBB(square(home, 1)) | squareBB(square(home, 2)) | squareBB(square(home, 3));
+    constexpr Bitboard queenSafe  = squareBB(square(home, 2)) | squareBB(square(home, 3));
+
+    if ((pos.state.castling & kingSide) && pos.board[home][7] == rook &&
+        !(pos.occupied & kingEmpty) && !(danger & kingEmpty)) {
+        addMove(pos, from, square(home, 6), moves);
+    }
+    if ((pos.state.castling & queenSide) && pos.board[home][0] == rook &&
+        !(pos.occupied & queenEmpty) && !(danger & queenSafe)) {
+        addMove(pos, from, square(home, 2), moves);
+    }
+}
@@ -61,10 +61,9 @@ bool Board::isMoveValid(const Move &move)
             if ((std::isupper(board[r2][c2]) != 0) == whitePiece)
                 return false; // nie można bić swojego
         } else {
-            // --- EP: bicie w przelocie, gdy cel jest pusty, ale = enPassant ---
-            if (enPassant != "-") {
-                int epRow, epCol;
-                if (algToCoord(enPassant, epRow, epCol) && epRow == r2 && epCol == c2) {
+            // --- EP: bicie w przelocie, gdy cel jest pusty, ale = pole EP ---
+            if (state.epSquare != NO_SQUARE) {
+                if (state.epSquare == r2 * 8 + c2) {
                     // sprawdzamy, czy faktycznie stoi pion przeciwnika "za" polem celu
                     int capRow = r2 - dir; // pion do zbicia stoi na rzędzie, z którego przechodziliśmy
                     int capCol = c2;